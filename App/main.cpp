@@ -20,6 +20,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 #include "MainWindow/MainWindow.h"
+#include "MainWindow/Headless.h"
 #include "Version.h"
 
 #include <QApplication>
@@ -27,6 +28,9 @@
 
 int main( int argc, char ** argv )
 {
+    if ( NHeadless::isHeadless( argc, argv ) )
+        return NHeadless::run( argc, argv );
+
     Q_INIT_RESOURCE( application );
     NSABUtils::initResources();
 
@@ -0,0 +1,86 @@
+// The MIT License( MIT )
+//
+// Copyright( c ) 2020-2021 Scott Aron Bloom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "DiffDlg.h"
+
+#include "ui_DiffDlg.h"
+#include "SABUtils/QtUtils.h"
+
+#include <unordered_map>
+
+CDiffDlg::CDiffDlg( const QString & summary, const std::vector< CQRCDiff::SChange > & changes, const std::vector< CQRCDiff::SConflict > & conflicts, QWidget * parent )
+    : QDialog( parent ),
+    fImpl( new Ui::CDiffDlg )
+{
+    fImpl->setupUi( this );
+    fImpl->summary->setText( summary );
+
+    if ( !conflicts.empty() )
+    {
+        auto conflictsItem = new QTreeWidgetItem( fImpl->changes, QStringList() << tr( "Conflicts" ) );
+        for ( auto && ii : conflicts )
+        {
+            auto item = new QTreeWidgetItem( conflictsItem, QStringList() << ii.fEntry.resourcePath() << ii.fEntry.fLang << tr( "Conflict" ) << ii.fDescription );
+            item->setBackground( 2, Qt::red );
+        }
+        conflictsItem->setExpanded( true );
+    }
+
+    std::unordered_map< QString, QTreeWidgetItem * > prefixItems;
+    for ( auto && ii : changes )
+    {
+        auto && entry = ( ii.fType == CQRCDiff::EChange::eRemoved ) ? ii.fOld : ii.fNew;
+
+        auto key = CQRCDocument::normalizedPrefix( entry.fPrefix ) + '\n' + entry.fLang;
+        auto pos = prefixItems.find( key );
+        if ( pos == prefixItems.end() )
+        {
+            auto prefixItem = new QTreeWidgetItem( fImpl->changes, QStringList() << entry.fPrefix << entry.fLang );
+            prefixItem->setExpanded( true );
+            pos = prefixItems.insert( { key, prefixItem } ).first;
+        }
+
+        QString change;
+        Qt::GlobalColor color = Qt::yellow;
+        switch ( ii.fType )
+        {
+            case CQRCDiff::EChange::eAdded:
+                change = tr( "Added" );
+                color = Qt::green;
+                break;
+            case CQRCDiff::EChange::eRemoved:
+                change = tr( "Removed" );
+                color = Qt::red;
+                break;
+            case CQRCDiff::EChange::eChanged:
+                change = tr( "Changed" );
+                break;
+        }
+        auto item = new QTreeWidgetItem( ( *pos ).second, QStringList() << entry.resourcePath() << entry.fLang << change << ii.fAttributes.join( ", " ) );
+        item->setBackground( 2, color );
+    }
+    NSABUtils::autoSize( fImpl->changes );
+}
+
+CDiffDlg::~CDiffDlg()
+{
+}
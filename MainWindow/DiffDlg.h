@@ -0,0 +1,45 @@
+// The MIT License( MIT )
+//
+// Copyright( c ) 2020-2021 Scott Aron Bloom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _DIFFDLG_H
+#define _DIFFDLG_H
+
+#include "QRCDiff.h"
+
+#include <QDialog>
+#include <memory>
+#include <vector>
+
+namespace Ui
+{
+    class CDiffDlg;
+}
+class CDiffDlg : public QDialog
+{
+    Q_OBJECT
+public:
+    CDiffDlg( const QString & summary, const std::vector< CQRCDiff::SChange > & changes, const std::vector< CQRCDiff::SConflict > & conflicts, QWidget * parent = nullptr );
+    virtual ~CDiffDlg() override;
+private:
+    std::unique_ptr< Ui::CDiffDlg > fImpl;
+};
+#endif
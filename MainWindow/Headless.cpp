@@ -0,0 +1,220 @@
+// The MIT License( MIT )
+//
+// Copyright( c ) 2020-2021 Scott Aron Bloom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Headless.h"
+#include "ImageOptimizer.h"
+#include "QRCDiff.h"
+#include "QRCDocument.h"
+#include "QRCIndexGenerator.h"
+#include "../Version.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+
+#include <cstring>
+
+namespace NHeadless
+{
+    // the options handled by run, anything else (-style, -platform, -reverse etc) is left for QApplication
+    static const char * sOptions[] = { "headless", "index-header", "canonical", "diff", "merge-base", "merge-theirs", "optimize-images", "output", "help", "help-all", "version" };
+
+    bool isHeadless( int argc, char ** argv )
+    {
+        for ( int ii = 1; ii < argc; ++ii )
+        {
+            auto arg = argv[ ii ];
+            if ( !arg || ( arg[ 0 ] != '-' ) )
+                continue;
+            if ( !std::strcmp( arg, "-h" ) || !std::strcmp( arg, "-?" ) || !std::strcmp( arg, "-v" ) )
+                return true;
+            if ( arg[ 1 ] != '-' )
+                continue;
+
+            // --name or --name=value
+            auto name = arg + 2;
+            auto len = std::strcspn( name, "=" );
+            for ( auto && option : sOptions )
+            {
+                if ( ( std::strlen( option ) == len ) && !std::strncmp( name, option, len ) )
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    int run( int argc, char ** argv )
+    {
+        QCoreApplication appl( argc, argv );
+        appl.setApplicationName( QString::fromStdString( NVersion::APP_NAME ) );
+        appl.setApplicationVersion( QString::fromStdString( NVersion::getVersionString( true ) ) );
+        appl.setOrganizationName( QString::fromStdString( NVersion::VENDOR ) );
+        appl.setOrganizationDomain( QString::fromStdString( NVersion::HOMEPAGE ) );
+
+        QTextStream out( stdout );
+        QTextStream err( stderr );
+
+        QCommandLineParser parser;
+        parser.setApplicationDescription( QObject::tr( "Stand alone replacement application for qrceditor" ) );
+        parser.addHelpOption();
+        parser.addVersionOption();
+
+        QCommandLineOption headlessOption( "headless", QObject::tr( "Run without the GUI, implied by any of the options below." ) );
+        parser.addOption( headlessOption );
+
+        QCommandLineOption indexHeaderOption( "index-header", QObject::tr( "Generate the resource index header <file>, only written when its contents change." ), "file" );
+        parser.addOption( indexHeaderOption );
+        QCommandLineOption canonicalOption( "canonical", QObject::tr( "Write the resource file back in canonical order, generated files use the same order." ) );
+        parser.addOption( canonicalOption );
+        QCommandLineOption diffOption( "diff", QObject::tr( "Print the structural changes from <file> to the resource file, exits with 1 when they differ." ), "file" );
+        parser.addOption( diffOption );
+        QCommandLineOption mergeBaseOption( "merge-base", QObject::tr( "Three way merge, the common ancestor <file> of the resource file and --merge-theirs." ), "file" );
+        parser.addOption( mergeBaseOption );
+        QCommandLineOption mergeTheirsOption( "merge-theirs", QObject::tr( "Three way merge, the <file> merged into the resource file, exits with 1 on conflicts." ), "file" );
+        parser.addOption( mergeTheirsOption );
+        QCommandLineOption optimizeImagesOption( "optimize-images", QObject::tr( "Losslessly recompress every referenced PNG image in parallel, storing the results in <dir>, and update the resource file to use them." ), "dir" );
+        parser.addOption( optimizeImagesOption );
+        QCommandLineOption outputOption( "output", QObject::tr( "Write the merged, optimized or canonical resource file to <file> rather than in place." ), "file" );
+        parser.addOption( outputOption );
+        parser.addPositionalArgument( "qrc", QObject::tr( "The resource file to process." ) );
+
+        parser.process( appl );
+
+        auto positional = parser.positionalArguments();
+        if ( positional.size() != 1 )
+        {
+            err << QObject::tr( "A single resource file is required" ) << "\n";
+            return -1;
+        }
+
+        CQRCDocument doc;
+        QString msg;
+        if ( !doc.load( positional.front(), &msg ) )
+        {
+            err << msg << "\n";
+            return -1;
+        }
+
+        auto loadDoc = [&err]( const QString & fileName, CQRCDocument & doc )
+        {
+            QString msg;
+            if ( doc.load( fileName, &msg ) )
+                return true;
+            err << msg << "\n";
+            return false;
+        };
+
+        int retVal = 0;
+        if ( parser.isSet( diffOption ) )
+        {
+            CQRCDocument other;
+            if ( !loadDoc( parser.value( diffOption ), other ) )
+                return -1;
+
+            auto changes = CQRCDiff::diff( other, doc );
+            for ( auto && ii : changes )
+                out << ii.toString() << "\n";
+            if ( !changes.empty() )
+                retVal = 1;
+        }
+
+        bool modified = false;
+        if ( parser.isSet( mergeBaseOption ) != parser.isSet( mergeTheirsOption ) )
+        {
+            err << QObject::tr( "--merge-base and --merge-theirs must be used together" ) << "\n";
+            return -1;
+        }
+        if ( parser.isSet( mergeBaseOption ) )
+        {
+            CQRCDocument base;
+            CQRCDocument theirs;
+            if ( !loadDoc( parser.value( mergeBaseOption ), base ) || !loadDoc( parser.value( mergeTheirsOption ), theirs ) )
+                return -1;
+
+            CQRCDocument merged;
+            std::vector< CQRCDiff::SConflict > conflicts;
+            if ( !CQRCDiff::merge( base, doc, theirs, merged, conflicts ) )
+            {
+                for ( auto && ii : conflicts )
+                    err << QObject::tr( "Conflict: %1" ).arg( ii.fDescription ) << "\n";
+                retVal = 1;
+            }
+            doc = merged;
+            modified = true;
+        }
+
+        if ( parser.isSet( optimizeImagesOption ) )
+        {
+            auto cacheDir = QDir( parser.value( optimizeImagesOption ) ).absolutePath();
+            auto relToDir = doc.relToDir();
+
+            std::vector< SQRCFile * > files;
+            std::vector< CImageOptimizer::SJob > jobs;
+            for ( auto && prefix : doc.prefixes() )
+            {
+                for ( auto && file : prefix.fFiles )
+                {
+                    if ( !CImageOptimizer::isCandidate( file.fFileName ) )
+                        continue;
+                    files.push_back( &file );
+                    jobs.push_back( { doc.absoluteFilePath( file ), cacheDir, file.fThreshold.isEmpty() ? 70 : file.fThreshold.toInt() } );
+                }
+            }
+
+            auto report = CImageOptimizer::run( jobs );
+            for ( size_t ii = 0; ii < files.size(); ++ii )
+                modified = CImageOptimizer::apply( report.fResults[ ii ], relToDir, *files[ ii ] ) || modified;
+            out << report.toString() << "\n";
+        }
+
+        auto canonical = parser.isSet( canonicalOption );
+        if ( canonical )
+        {
+            doc = doc.canonicalized();
+            modified = true;
+        }
+
+        if ( modified )
+        {
+            auto outFile = parser.isSet( outputOption ) ? parser.value( outputOption ) : doc.fileName();
+            if ( !doc.rebased( outFile ).save( outFile, &msg, canonical ) )
+            {
+                err << msg << "\n";
+                return -1;
+            }
+        }
+
+        if ( parser.isSet( indexHeaderOption ) )
+        {
+            auto headerFile = parser.value( indexHeaderOption );
+            bool changed = false;
+            if ( !CQRCIndexGenerator( doc ).write( headerFile, &changed, &msg ) )
+            {
+                err << msg << "\n";
+                retVal = -1;
+            }
+            else
+                out << ( changed ? QObject::tr( "Wrote '%1'" ) : QObject::tr( "'%1' is up to date" ) ).arg( headerFile ) << "\n";
+        }
+        return retVal;
+    }
+}
@@ -0,0 +1,214 @@
+// The MIT License( MIT )
+//
+// Copyright( c ) 2020-2021 Scott Aron Bloom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ImageOptimizer.h"
+
+#include <QtConcurrent>
+#include <QBuffer>
+#include <QColorSpace>
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QImageWriter>
+#include <QLocale>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cstring>
+
+bool CImageOptimizer::isCandidate( const QString & fileName )
+{
+    return fileName.endsWith( ".png", Qt::CaseInsensitive );
+}
+
+// copying the pixels drops the text chunks, the colour space (iCCP, gAMA, sRGB) is kept as it changes how the pixels display
+QImage strippedImage( const QImage & image )
+{
+    QImage retVal( image.size(), image.format() );
+    retVal.setColorTable( image.colorTable() );
+    retVal.setColorSpace( image.colorSpace() );
+    auto numBytes = std::min( retVal.bytesPerLine(), image.bytesPerLine() );
+    for ( int ii = 0; ii < image.height(); ++ii )
+        std::memcpy( retVal.scanLine( ii ), image.constScanLine( ii ), numBytes );
+    return retVal;
+}
+
+bool samePixels( const QImage & lhs, const QImage & rhs )
+{
+    if ( ( lhs.size() != rhs.size() ) || ( lhs.colorSpace() != rhs.colorSpace() ) )
+        return false;
+    if ( lhs.format() == rhs.format() )
+        return lhs == rhs;
+    return lhs.convertToFormat( QImage::Format_ARGB32 ) == rhs.convertToFormat( QImage::Format_ARGB32 );
+}
+
+CImageOptimizer::SResult CImageOptimizer::optimize( const SJob & job )
+{
+    SResult retVal;
+    retVal.fSource = job.fSource;
+
+    QFile file( job.fSource );
+    if ( !file.open( QFile::ReadOnly ) )
+    {
+        retVal.fMessage = QObject::tr( "Could not open" );
+        return retVal;
+    }
+
+    auto data = file.readAll();
+    retVal.fOriginalBytes = retVal.fOutputBytes = data.size();
+
+    // the suffix is bumped when the output changes, older entries dropped the colour space
+    auto cachedFile = QDir( job.fCacheDir ).absoluteFilePath( QString::fromLatin1( QCryptographicHash::hash( data, QCryptographicHash::Sha1 ).toHex() ) + "_2.png" );
+    auto best = data;
+
+    QFile cached( cachedFile );
+    if ( cached.open( QFile::ReadOnly ) )
+    {
+        // verified when it was written
+        best = cached.readAll();
+        retVal.fOutput = cachedFile;
+        retVal.fMessage = QObject::tr( "Cached" );
+    }
+    else
+    {
+        QImage image;
+        if ( !image.loadFromData( data, "PNG" ) )
+            retVal.fMessage = QObject::tr( "Not a readable PNG" );
+        else if ( image.depth() > 32 )
+            retVal.fMessage = QObject::tr( "Images with more than 8 bits per channel are not recompressed" );
+        else
+        {
+            QBuffer buffer;
+            buffer.open( QBuffer::WriteOnly );
+            QImageWriter writer( &buffer, "PNG" );
+            writer.setQuality( 0 ); // the png writer maps quality 0 to deflate level 9
+            QImage check;
+            if ( !writer.write( strippedImage( image ) ) )
+                retVal.fMessage = writer.errorString();
+            else if ( !check.loadFromData( buffer.data(), "PNG" ) || !samePixels( image, check ) )
+                retVal.fMessage = QObject::tr( "Verification failed, original kept" );
+            else if ( buffer.data().size() >= data.size() )
+                retVal.fMessage = QObject::tr( "No gain, original kept" );
+            else
+            {
+                QSaveFile out( cachedFile );
+                if ( !QDir().mkpath( job.fCacheDir ) || !out.open( QFile::WriteOnly ) || ( out.write( buffer.data() ) != buffer.data().size() ) || !out.commit() )
+                    retVal.fMessage = QObject::tr( "Could not write '%1'" ).arg( cachedFile );
+                else
+                {
+                    best = buffer.data();
+                    retVal.fOutput = cachedFile;
+                }
+            }
+        }
+    }
+    retVal.fOutputBytes = best.size();
+
+    // rcc only uses the compressed data when it saves at least threshold percent
+    if ( !best.isEmpty() )
+    {
+        auto compressedBytes = qCompress( best, 9 ).size() - 4; // qCompress prepends the size
+        auto savedPercent = 100.0 * ( best.size() - compressedBytes ) / best.size();
+        retVal.fDisableCompression = savedPercent < job.fThreshold;
+    }
+    return retVal;
+}
+
+QFuture< CImageOptimizer::SResult > CImageOptimizer::start( const std::vector< SJob > & jobs )
+{
+    return QtConcurrent::mapped( jobs, &CImageOptimizer::optimize );
+}
+
+CImageOptimizer::SReport CImageOptimizer::run( const std::vector< SJob > & jobs )
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    auto future = start( jobs );
+    future.waitForFinished();
+
+    SReport retVal;
+    auto results = future.results();
+    retVal.fResults.assign( results.begin(), results.end() );
+    retVal.fElapsedMS = timer.elapsed();
+    return retVal;
+}
+
+bool CImageOptimizer::apply( const SResult & result, const QDir & relToDir, SQRCFile & file )
+{
+    bool retVal = false;
+    if ( !result.fOutput.isEmpty() )
+    {
+        auto resourceName = file.resourceName();
+        file.fFileName = relToDir.relativeFilePath( result.fOutput );
+        if ( file.fAlias.isEmpty() )
+            file.fAlias = resourceName;
+        retVal = true;
+    }
+
+    if ( result.fDisableCompression && ( file.fAlgo != "none" ) )
+    {
+        file.fAlgo = "none";
+        file.fLevel.clear();
+        file.fThreshold.clear();
+        retVal = true;
+    }
+    return retVal;
+}
+
+qint64 CImageOptimizer::SReport::bytesSaved() const
+{
+    qint64 retVal = 0;
+    for ( auto && ii : fResults )
+        retVal += ii.fOriginalBytes - ii.fOutputBytes;
+    return retVal;
+}
+
+QString CImageOptimizer::SReport::toString() const
+{
+    QLocale locale;
+    qint64 originalBytes = 0;
+    int numOptimized = 0;
+    int numUncompressed = 0;
+    QStringList details;
+    for ( auto && ii : fResults )
+    {
+        originalBytes += ii.fOriginalBytes;
+        if ( !ii.fOutput.isEmpty() )
+            numOptimized++;
+        if ( ii.fDisableCompression )
+            numUncompressed++;
+        if ( !ii.fMessage.isEmpty() )
+            details << QString( "%1: %2" ).arg( ii.fSource ).arg( ii.fMessage );
+    }
+
+    QStringList retVal;
+    retVal << QObject::tr( "Processed %1 image(s) in %2 seconds" ).arg( fResults.size() ).arg( fElapsedMS / 1000.0, 0, 'f', 2 );
+    retVal << QObject::tr( "Recompressed: %1 image(s)" ).arg( numOptimized );
+    retVal << QObject::tr( "Total saved: %1 of %2" ).arg( locale.formattedDataSize( bytesSaved() ) ).arg( locale.formattedDataSize( originalBytes ) );
+    retVal << QObject::tr( "rcc compression disabled: %1 image(s)" ).arg( numUncompressed );
+    if ( !details.isEmpty() )
+        retVal << QString() << details;
+    return retVal.join( "\n" );
+}
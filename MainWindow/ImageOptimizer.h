@@ -0,0 +1,78 @@
+// The MIT License( MIT )
+//
+// Copyright( c ) 2020-2021 Scott Aron Bloom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _IMAGEOPTIMIZER_H
+#define _IMAGEOPTIMIZER_H
+
+#include "QRCDocument.h"
+
+#include <QString>
+#include <QFuture>
+#include <vector>
+
+// Lossless recompression of the PNG images referenced by a resource file.
+// Images are re-encoded with the strongest deflate setting and without text metadata, the colour space is kept.
+// The result is only used when it decodes to identical pixels in the same colour space and is smaller.
+// Results are stored in a cache directory keyed by the SHA-1 of the original contents, so unchanged images
+// are not processed again
+class CImageOptimizer
+{
+public:
+    struct SJob
+    {
+        QString fSource;
+        QString fCacheDir;
+        int fThreshold{ 70 }; // the entry's rcc compression threshold
+    };
+
+    struct SResult
+    {
+        QString fSource;
+        QString fOutput; // empty when the original is kept
+        qint64 fOriginalBytes{ 0 };
+        qint64 fOutputBytes{ 0 };
+        bool fDisableCompression{ false }; // rcc would not gain enough to meet the threshold
+        QString fMessage;
+    };
+
+    struct SReport
+    {
+        std::vector< SResult > fResults;
+        qint64 fElapsedMS{ 0 };
+
+        qint64 bytesSaved() const;
+        QString toString() const;
+    };
+
+    static bool isCandidate( const QString & fileName );
+
+    // thread safe
+    static SResult optimize( const SJob & job );
+
+    // runs on the global thread pool
+    static QFuture< SResult > start( const std::vector< SJob > & jobs );
+    static SReport run( const std::vector< SJob > & jobs );
+
+    // points the entry at the optimized image, pinning its resource path with an alias, returns true if the entry changed
+    static bool apply( const SResult & result, const QDir & relToDir, SQRCFile & file );
+};
+#endif
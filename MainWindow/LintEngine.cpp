@@ -0,0 +1,284 @@
+// The MIT License( MIT )
+//
+// Copyright( c ) 2020-2021 Scott Aron Bloom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "LintEngine.h"
+
+#include <QFileInfo>
+#include <QLocale>
+#include <QMutexLocker>
+
+static const qint64 kLargeFileBytes = 1024 * 1024;
+static const int kNumLargest = 10;
+
+CLintEngine::CLintEngine( QObject * parent ) :
+    QThread( parent )
+{
+    qRegisterMetaType< CLintEngine::TResults >( "CLintEngine::TResults" );
+}
+
+CLintEngine::~CLintEngine()
+{
+    requestInterruption();
+    {
+        QMutexLocker locker( &fMutex );
+        fWait.wakeAll();
+    }
+    wait();
+}
+
+QString CLintEngine::toString( ESeverity severity )
+{
+    switch ( severity )
+    {
+        case ESeverity::eError:
+            return tr( "Error" );
+        case ESeverity::eWarning:
+            return tr( "Warning" );
+        case ESeverity::eInfo:
+            return tr( "Info" );
+    }
+    return QString();
+}
+
+void CLintEngine::updateEntry( quint64 id, const SEntry & entry )
+{
+    SOp op;
+    op.fType = SOp::EType::eUpdate;
+    op.fID = id;
+    op.fEntry = entry;
+    enqueue( std::move( op ) );
+}
+
+void CLintEngine::removeEntry( quint64 id )
+{
+    SOp op;
+    op.fType = SOp::EType::eRemove;
+    op.fID = id;
+    enqueue( std::move( op ) );
+}
+
+void CLintEngine::clear()
+{
+    SOp op;
+    op.fType = SOp::EType::eClear;
+    enqueue( std::move( op ) );
+}
+
+void CLintEngine::enqueue( SOp && op )
+{
+    QMutexLocker locker( &fMutex );
+    fPending.push_back( std::move( op ) );
+    fWait.wakeAll();
+}
+
+void CLintEngine::run()
+{
+    while ( !isInterruptionRequested() )
+    {
+        std::vector< SOp > ops;
+        {
+            QMutexLocker locker( &fMutex );
+            while ( fPending.empty() && !isInterruptionRequested() )
+                fWait.wait( &fMutex );
+            ops.swap( fPending );
+        }
+
+        std::unordered_set< quint64 > dirty;
+        for ( auto && op : ops )
+        {
+            if ( isInterruptionRequested() )
+                return;
+
+            switch ( op.fType )
+            {
+                case SOp::EType::eUpdate:
+                    update( op.fID, op.fEntry, dirty );
+                    break;
+                case SOp::EType::eRemove:
+                    remove( op.fID, dirty );
+                    break;
+                case SOp::EType::eClear:
+                    fEntries.clear();
+                    fKeys.clear();
+                    fBySize.clear();
+                    fLargest.clear();
+                    fTotalBytes = 0;
+                    dirty.clear();
+                    break;
+            }
+        }
+        if ( dirty.empty() )
+            continue;
+
+        // the ranks and shares of the largest contributors change with any size change, they are always re-checked
+        std::unordered_map< quint64, int > largest;
+        int rank = 1;
+        for ( auto ii = fBySize.rbegin(); ( ii != fBySize.rend() ) && ( rank <= kNumLargest ) && ( ( *ii ).first > 0 ); ++ii )
+            largest[ ( *ii ).second ] = rank++;
+        for ( auto && ii : fLargest )
+            dirty.insert( ii.first );
+        for ( auto && ii : largest )
+            dirty.insert( ii.first );
+        fLargest = largest;
+
+        TResults results;
+        results.reserve( static_cast< int >( dirty.size() ) );
+        for ( auto && ii : dirty )
+            results.push_back( lint( ii ) );
+        emit sigProblemsChanged( results );
+    }
+}
+
+void CLintEngine::remove( quint64 id, std::unordered_set< quint64 > & dirty )
+{
+    auto pos = fEntries.find( id );
+    if ( pos == fEntries.end() )
+        return;
+
+    auto && state = ( *pos ).second;
+    if ( !state.fEntry.fIsPrefix )
+    {
+        auto keyPos = fKeys.find( state.fKey );
+        if ( keyPos != fKeys.end() )
+        {
+            ( *keyPos ).second.erase( id );
+            dirty.insert( ( *keyPos ).second.begin(), ( *keyPos ).second.end() );
+            if ( ( *keyPos ).second.empty() )
+                fKeys.erase( keyPos );
+        }
+        fBySize.erase( std::make_pair( state.fSize, id ) );
+        fTotalBytes -= state.fSize;
+    }
+    fEntries.erase( pos );
+    dirty.insert( id );
+}
+
+void CLintEngine::update( quint64 id, const SEntry & entry, std::unordered_set< quint64 > & dirty )
+{
+    remove( id, dirty );
+
+    SState state;
+    state.fEntry = entry;
+    if ( !entry.fIsPrefix )
+    {
+        auto fi = QFileInfo( entry.fAbsPath );
+        state.fExists = fi.isFile();
+        state.fSize = state.fExists ? fi.size() : 0;
+        state.fKey = entry.fLang + '\n' + CQRCDocument::resourcePath( entry.fPrefix, entry.fFile );
+
+        auto && ids = fKeys[ state.fKey ];
+        dirty.insert( ids.begin(), ids.end() );
+        ids.insert( id );
+
+        fBySize.insert( std::make_pair( state.fSize, id ) );
+        fTotalBytes += state.fSize;
+    }
+    fEntries[ id ] = state;
+    dirty.insert( id );
+}
+
+bool isCompressedFormat( const QString & fileName )
+{
+    static const std::unordered_set< QString > sSuffixes =
+    {
+        "png", "jpg", "jpeg", "gif", "webp", "svgz",
+        "zip", "gz", "tgz", "bz2", "xz", "7z", "zst", "rcc",
+        "mp3", "mp4", "m4a", "aac", "ogg", "oga", "ogv", "opus", "webm", "flac",
+        "woff", "woff2"
+    };
+    return sSuffixes.count( QFileInfo( fileName ).suffix().toLower() ) != 0;
+}
+
+CLintEngine::SResult CLintEngine::lint( quint64 id ) const
+{
+    SResult retVal;
+    retVal.fID = id;
+
+    auto pos = fEntries.find( id );
+    if ( pos == fEntries.end() )
+        return retVal;
+
+    auto && state = ( *pos ).second;
+    auto && entry = state.fEntry;
+    auto addProblem = [&retVal]( ESeverity severity, const QString & msg ) { retVal.fProblems.push_back( { severity, msg } ); };
+
+    if ( entry.fIsPrefix )
+    {
+        retVal.fResourcePath = entry.fPrefix;
+        if ( entry.fPrefix.contains( '\\' ) )
+            addProblem( ESeverity::eError, tr( "Prefix contains a backslash, resource paths only use '/'" ) );
+        if ( entry.fPrefix != entry.fPrefix.trimmed() )
+            addProblem( ESeverity::eWarning, tr( "Prefix has leading or trailing whitespace" ) );
+        auto segments = entry.fPrefix.split( '/' );
+        for ( int ii = 0; ii < segments.size(); ++ii )
+        {
+            auto && segment = segments[ ii ];
+            if ( ( segment == "." ) || ( segment == ".." ) || ( segment.isEmpty() && ( ii != 0 ) && ( ii != ( segments.size() - 1 ) ) ) )
+            {
+                addProblem( ESeverity::eWarning, tr( "Prefix contains empty or relative path segments, rcc registers it as '%1'" ).arg( QDir::cleanPath( CQRCDocument::normalizedPrefix( entry.fPrefix ) ) ) );
+                break;
+            }
+        }
+        return retVal;
+    }
+
+    retVal.fResourcePath = CQRCDocument::resourcePath( entry.fPrefix, entry.fFile );
+    QLocale locale;
+
+    if ( !state.fExists )
+        addProblem( ESeverity::eError, tr( "File '%1' does not exist" ).arg( entry.fAbsPath ) );
+
+    auto keyPos = fKeys.find( state.fKey );
+    if ( ( keyPos != fKeys.end() ) && ( ( *keyPos ).second.size() > 1 ) )
+        addProblem( ESeverity::eError, tr( "Resource path is used by %1 entries, only one is reachable" ).arg( ( *keyPos ).second.size() ) );
+
+    if ( entry.fFile.fAlias.contains( '\\' ) )
+        addProblem( ESeverity::eError, tr( "Alias contains a backslash, resource paths only use '/'" ) );
+
+    auto algo = entry.fFile.fAlgo.toLower();
+    bool compressed = ( algo != "none" );
+    if ( !compressed && ( state.fSize > kLargeFileBytes ) )
+        addProblem( ESeverity::eWarning, tr( "Large uncompressed file (%1) is stored as is in the binary" ).arg( locale.formattedDataSize( state.fSize ) ) );
+
+    if ( !entry.fFile.fThreshold.isEmpty() )
+    {
+        bool aOK = false;
+        auto threshold = entry.fFile.fThreshold.toInt( &aOK );
+        if ( !aOK || ( threshold < 0 ) )
+            addProblem( ESeverity::eError, tr( "Invalid compression threshold '%1'" ).arg( entry.fFile.fThreshold ) );
+        else if ( !compressed )
+            addProblem( ESeverity::eInfo, tr( "Compression threshold has no effect when compression is none" ) );
+        else if ( threshold >= 100 )
+            addProblem( ESeverity::eWarning, tr( "Compression threshold of %1% can never be met, the file is never compressed" ).arg( threshold ) );
+    }
+
+    if ( ( algo.isEmpty() || ( algo == "best" ) ) && isCompressedFormat( entry.fFile.fFileName ) )
+        addProblem( ESeverity::eInfo, tr( "Already compressed format set to Best, rcc compression only costs build time, consider none" ) );
+
+    auto largestPos = fLargest.find( id );
+    if ( largestPos != fLargest.end() )
+    {
+        auto percent = fTotalBytes ? ( 100.0 * state.fSize / fTotalBytes ) : 0.0;
+        addProblem( ESeverity::eInfo, tr( "Largest contributor #%1 to the binary size: %2 (%3% of all resources)" ).arg( ( *largestPos ).second ).arg( locale.formattedDataSize( state.fSize ) ).arg( percent, 0, 'f', 1 ) );
+    }
+    return retVal;
+}
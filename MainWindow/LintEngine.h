@@ -0,0 +1,128 @@
+// The MIT License( MIT )
+//
+// Copyright( c ) 2020-2021 Scott Aron Bloom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _LINTENGINE_H
+#define _LINTENGINE_H
+
+#include "QRCDocument.h"
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QVector>
+#include <QList>
+#include <QHash>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Background checker for resource file entries.
+// Entries are identified by the caller, each update only re-checks that entry, the entries sharing its
+// resource path and the largest contributors, so an edit costs a single file stat no matter the document size
+class CLintEngine : public QThread
+{
+    Q_OBJECT
+public:
+    enum class ESeverity
+    {
+        eError,
+        eWarning,
+        eInfo
+    };
+
+    struct SProblem
+    {
+        ESeverity fSeverity{ ESeverity::eWarning };
+        QString fMessage;
+    };
+
+    struct SEntry
+    {
+        bool fIsPrefix{ false };
+        QString fPrefix;
+        QString fLang;
+        SQRCFile fFile; // unused for prefixes
+        QString fAbsPath;
+    };
+
+    // all the current problems of an entry, empty when it is clean or was removed
+    struct SResult
+    {
+        quint64 fID{ 0 };
+        QString fResourcePath;
+        QList< SProblem > fProblems;
+    };
+    using TResults = QVector< SResult >;
+
+    CLintEngine( QObject * parent = nullptr );
+    virtual ~CLintEngine() override;
+
+    // thread safe, processed in order on the lint thread
+    void updateEntry( quint64 id, const SEntry & entry );
+    void removeEntry( quint64 id );
+    void clear();
+
+    static QString toString( ESeverity severity );
+Q_SIGNALS:
+    void sigProblemsChanged( const CLintEngine::TResults & results );
+protected:
+    virtual void run() override;
+private:
+    struct SOp
+    {
+        enum class EType
+        {
+            eUpdate,
+            eRemove,
+            eClear
+        } fType{ EType::eUpdate };
+        quint64 fID{ 0 };
+        SEntry fEntry;
+    };
+
+    struct SState
+    {
+        SEntry fEntry;
+        QString fKey;
+        bool fExists{ false };
+        qint64 fSize{ 0 };
+    };
+
+    void enqueue( SOp && op );
+    void remove( quint64 id, std::unordered_set< quint64 > & dirty );
+    void update( quint64 id, const SEntry & entry, std::unordered_set< quint64 > & dirty );
+    SResult lint( quint64 id ) const;
+
+    QMutex fMutex;
+    QWaitCondition fWait;
+    std::vector< SOp > fPending;
+
+    // only used on the lint thread
+    std::unordered_map< quint64, SState > fEntries;
+    std::unordered_map< QString, std::unordered_set< quint64 > > fKeys;
+    std::set< std::pair< qint64, quint64 > > fBySize;
+    std::unordered_map< quint64, int > fLargest; // id -> rank
+    qint64 fTotalBytes{ 0 };
+};
+Q_DECLARE_METATYPE( CLintEngine::TResults )
+#endif
@@ -21,6 +21,12 @@
 // SOFTWARE.
 
 #include "MainWindow.h"
+#include "QRCDocument.h"
+#include "QRCIndexGenerator.h"
+#include "PartitionDlg.h"
+#include "DiffDlg.h"
+#include "ImageOptimizer.h"
+#include "QRCDiff.h"
 #include "../Version.h"
 
 #include "ui_MainWindow.h"
@@ -33,20 +39,24 @@
 #include <QMenu>
 #include <QAction>
 #include <QMessageBox>
-#include <QXmlQuery>
-#include <QXmlResultItems>
-#include <QXmlStreamWriter>
 #include <QCloseEvent>
 #include <QFile>
 #include <QDebug>
 #include <QFileIconProvider>
+#include <QSettings>
+#include <QStatusBar>
+#include <QProgressDialog>
+#include <QFutureWatcher>
+#include <QElapsedTimer>
 
 #include <set>
 
 
 CMainWindow::CMainWindow( QWidget * parent )
     : QMainWindow( parent ),
-    fImpl( new Ui::CMainWindow )
+    fImpl( new Ui::CMainWindow ),
+    fLintEngine( new CLintEngine ),
+    fPreviewLoader( new CPreviewLoader )
 {
     fImpl->setupUi( this );
     //setWindowIcon( style()->standardIcon( QStyle::SP_DialogSaveButton )
@@ -61,6 +71,22 @@ CMainWindow::CMainWindow( QWidget * parent )
     connect( fImpl->actionSaveAs, &QAction::triggered, this, &CMainWindow::slotSaveAs );
     connect( fImpl->actionAddFiles, &QAction::triggered, this, &CMainWindow::slotAddFiles );
     connect( fImpl->actionAddPrefix, &QAction::triggered, this, &CMainWindow::slotAddPrefix );
+    connect( fImpl->actionPartition, &QAction::triggered, this, &CMainWindow::slotPartition );
+    connect( fImpl->actionCompare, &QAction::triggered, this, &CMainWindow::slotCompare );
+    connect( fImpl->actionMerge, &QAction::triggered, this, &CMainWindow::slotMerge );
+    connect( fImpl->actionOptimizeImages, &QAction::triggered, this, &CMainWindow::slotOptimizeImages );
+    connect( fImpl->actionGenerateIndexHeader, &QAction::toggled,
+             []( bool checked )
+             {
+                 QSettings settings;
+                 settings.setValue( "GenerateIndexHeader", checked );
+             } );
+    connect( fImpl->actionCanonicalSave, &QAction::toggled,
+             []( bool checked )
+             {
+                 QSettings settings;
+                 settings.setValue( "CanonicalSave", checked );
+             } );
     connect( fImpl->removeBtn, &QPushButton::clicked, this, &CMainWindow::slotRemove );
 
     connect( fImpl->actionAbout, &QAction::triggered,
@@ -78,12 +104,24 @@ CMainWindow::CMainWindow( QWidget * parent )
 
     connect( fImpl->compression, &QComboBox::currentTextChanged, this, &CMainWindow::slotCompAlgoChanged );
     connect( fImpl->files, &QTreeWidget::currentItemChanged, this, &CMainWindow::slotItemChanged );
+    connect( fImpl->problems, &QTreeWidget::itemActivated, this, &CMainWindow::slotProblemActivated );
+    connect( fLintEngine.get(), &CLintEngine::sigProblemsChanged, this, &CMainWindow::slotProblemsChanged );
+    fImpl->menuTools->addSeparator();
+    fImpl->menuTools->addAction( fImpl->problemsDock->toggleViewAction() );
+    fImpl->menuTools->addAction( fImpl->previewDock->toggleViewAction() );
+    connect( fPreviewLoader.get(), &CPreviewLoader::sigPreviewReady, this, &CMainWindow::slotPreviewReady );
+    connect( fImpl->previewDock, &QDockWidget::visibilityChanged, this, [this]() { updatePreview( fImpl->files->currentItem() ); } );
+    fLintEngine->start( QThread::LowPriority );
 
     auto menu = new QMenu( fImpl->addButton );
     menu->addAction( fImpl->actionAddFiles );
     menu->addAction( fImpl->actionAddPrefix );
     fImpl->addButton->setMenu( menu );
 
+    QSettings settings;
+    fImpl->actionGenerateIndexHeader->setChecked( settings.value( "GenerateIndexHeader", false ).toBool() );
+    fImpl->actionCanonicalSave->setChecked( settings.value( "CanonicalSave", false ).toBool() );
+
     slotItemChanged( nullptr, nullptr );
     slotCompAlgoChanged( fImpl->compression->currentText() );
 }
@@ -169,19 +207,54 @@ void CMainWindow::loadFromItem( QTreeWidgetItem * item )
             threshold = "70";
         fImpl->threshold->setValue( threshold.toInt() );
 
-        auto fnName = item->parent()->text( 0 );
         auto currName = item->text( 2 );
         if ( currName.isEmpty() )
-            currName = item->text( 0 );
-        if ( currName.startsWith( "./" ) || currName.startsWith( ".\\" ) )
-            currName = currName.mid( 2 );
-        fnName += currName;
+            currName = CQRCDocument::normalizedFileName( item->text( 0 ) );
+        auto resourcePath = CQRCDocument::resourcePath( item->parent()->text( 0 ), currName );
+
+        fImpl->resourcePath->setText( resourcePath );
+        fImpl->resourceURL->setText( QString( "qrc://%1" ).arg( resourcePath.mid( 1 ) ) );
+    }
 
-        fImpl->resourcePath->setText( QString( ":%1" ).arg( fnName ) );
-        fImpl->resourceURL->setText( QString( "qrc://%1" ).arg( fnName ) );
+    updatePreview( item );
+}
+
+void CMainWindow::updatePreview( QTreeWidgetItem * item )
+{
+    // decoded off the GUI thread, a newer selection drops the pending one
+    fPreviewPath.clear();
+    if ( item && item->parent() && fImpl->previewDock->isVisible() )
+    {
+        QDir relToDir;
+        if ( !fFileName.isEmpty() )
+            relToDir = QFileInfo( fFileName ).absoluteDir();
+        fPreviewPath = relToDir.absoluteFilePath( CQRCDocument::normalizedFileName( item->text( 0 ) ) );
+        showPreview( { fPreviewPath, QImage(), QString(), tr( "Loading..." ) } );
+        fPreviewLoader->request( fPreviewPath );
+    }
+    else
+    {
+        fPreviewLoader->cancel();
+        showPreview( CPreviewLoader::SPreview() );
     }
 }
 
+void CMainWindow::slotPreviewReady( const CPreviewLoader::SPreview & preview )
+{
+    if ( preview.fPath != fPreviewPath )
+        return;
+    showPreview( preview );
+}
+
+void CMainWindow::showPreview( const CPreviewLoader::SPreview & preview )
+{
+    fImpl->previewImage->setPixmap( preview.fImage.isNull() ? QPixmap() : QPixmap::fromImage( preview.fImage ) );
+    fImpl->previewImage->setVisible( !preview.fImage.isNull() );
+    fImpl->previewText->setPlainText( preview.fText );
+    fImpl->previewText->setVisible( !preview.fText.isEmpty() );
+    fImpl->previewInfo->setText( preview.fInfo );
+}
+
 void CMainWindow::setModified( bool modified, bool force )
 {
     if ( force || ( fModified != modified ) )
@@ -243,6 +316,8 @@ void CMainWindow::saveToItem( QTreeWidgetItem * prev )
         changed = set( prev, 5, compEnabled ? fImpl->level->value() : fDefaultCompLevel, fDefaultCompLevel ) || changed;
         changed = set( prev, 6, compEnabled ? fImpl->threshold->value() : 70, 70 ) || changed;
     }
+    if ( changed )
+        lintItem( prev );
     setModified( fModified || changed );
 }
 
@@ -257,23 +332,6 @@ void CMainWindow::slotOpen()
     setQRCFile( fn );
 }
 
-QString getString( QXmlQuery & query, const QString & queryString )
-{
-    query.setQuery( queryString );
-    Q_ASSERT( query.isValid() );
-
-    QString retVal;
-    query.evaluateTo( &retVal );
-    retVal = retVal.trimmed();
-    return retVal;
-}
-
-int getInt( QXmlQuery & query, const QString & queryString, bool needsCount )
-{
-    auto stringValue = getString( query, needsCount ? QString( "count(%1)" ).arg( queryString ) : queryString );
-    return stringValue.toInt();
-}
-
 QString getAliasedPath( const QDir & relToDir, const QString & alias, const QString & fn )
 {
     auto retVal = alias;
@@ -298,31 +356,32 @@ struct SFileInfo
     }
 
 
-    SFileInfo( QXmlQuery & query, const QString & fileQueryString, int fileNum )
+    explicit SFileInfo( const SQRCFile & file ) :
+        fAlias( file.fAlias ),
+        fThreshold( file.fThreshold ),
+        fAlgo( file.fAlgo ),
+        fLevel( file.fLevel ),
+        fFileName( file.fFileName )
     {
-        auto fileQuery = QString( "%1[%2]" ).arg( fileQueryString ).arg( fileNum );
-
-        fAlias = getString( query, QString( "%1/@alias/string()" ).arg( fileQuery ) );
-        fThreshold = getString( query, QString( "%1/@threshold/string()" ).arg( fileQuery ) );
-        fAlgo = getString( query, QString( "%1/@compress-algo/string()" ).arg( fileQuery ) );
-        fLevel = getString( query, QString( "%1/@compress/string()" ).arg( fileQuery ) );
-        fFileName = getString( query, QString( "%1/string()" ).arg( fileQuery ) );
     }
 
-    QTreeWidgetItem * addFile( const QDir & relToDir, QTreeWidgetItem * parent ) const
+    QTreeWidgetItem * addFile( const QDir & relToDir, QTreeWidgetItem * parent, bool checkExisting = true ) const
     {
         if ( !parent )
             return nullptr;
         
-        auto searchPath = getAliasedPath( relToDir, fAlias, fFileName );
-        for ( int ii = 0; ii < parent->childCount(); ++ii )
+        if ( checkExisting )
         {
-            auto child = parent->child( ii );
-            if ( !child )
-                continue;
-            auto aliasPath = getAliasedPath( relToDir, child );
-            if ( searchPath == aliasPath )
-                return nullptr;
+            auto searchPath = getAliasedPath( relToDir, fAlias, fFileName );
+            for ( int ii = 0; ii < parent->childCount(); ++ii )
+            {
+                auto child = parent->child( ii );
+                if ( !child )
+                    continue;
+                auto aliasPath = getAliasedPath( relToDir, child );
+                if ( searchPath == aliasPath )
+                    return nullptr;
+            }
         }
 
         auto absPath = relToDir.absoluteFilePath( fFileName );
@@ -349,26 +408,6 @@ struct SFileInfo
     QString fFileName;
 };
 
-void CMainWindow::loadPrefix( const QDir & relToDir, QXmlQuery & query, int pos )
-{
-    auto prefix = getString( query, QString( "/RCC/qresource[%1]/@prefix/string()" ).arg( pos ) );
-    if ( prefix.isEmpty() )
-        prefix = "/";
-
-    auto lang = getString( query, QString( "/RCC/qresource[%1]/@lang/string()" ).arg( pos ) );
-
-    auto filesQueryString = QString( "/RCC/qresource[%1]/file" ).arg( pos );
-
-    auto cnt = getInt( query, filesQueryString, true );
-
-    for ( int ii = 1; ii <= cnt; ++ii )
-    {
-        auto file = SFileInfo( query, filesQueryString, ii );
-        loadFile( relToDir, prefix, lang, file );
-    }
-}
-
-
 void CMainWindow::loadFile( const QDir & relToDir, const QString & prefix, const QString & lang, const QString & path )
 {
     SFileInfo fi( path, relToDir );
@@ -379,7 +418,7 @@ void CMainWindow::loadFile( const QDir & relToDir, const QString & prefix, const
 {
     auto prefixItem = addPrefix( prefix, lang );
 
-    fileInfo.addFile( relToDir, prefixItem );
+    lintItem( fileInfo.addFile( relToDir, prefixItem ) );
     prefixItem->setExpanded( true );
     NSABUtils::autoSize( fImpl->files );
 }
@@ -407,31 +446,42 @@ QTreeWidgetItem * CMainWindow::addPrefix( const QString & prefix, const QString
 
 bool CMainWindow::setQRCFile( const QString & fileName )
 {
-    QFile file( fileName );
-    if ( !file.open( QFile::ReadOnly | QFile::Text ) )
+    CQRCDocument doc;
+    QString msg;
+    if ( !doc.load( fileName, &msg ) )
     {
-        QMessageBox::critical( this, tr( "Could not open Resource File" ), tr( "Could not open Resource File '%1'" ).arg( fileName ) );
+        QMessageBox::critical( this, tr( "Could not open Resource File" ), msg );
         return false;
     }
 
-    auto dir = QFileInfo( fileName ).absoluteDir();
+    setDocument( doc );
+    setModified( false, true );
+    return true;
+}
 
+void CMainWindow::setDocument( const CQRCDocument & doc )
+{
     fPrefixMap.clear();
-    fFileName.clear();
     fImpl->files->clear();
-
-    QXmlQuery query;
-    query.setFocus( &file );
-
-    auto cnt = getInt( query, "/RCC/qresource", true );
-    for ( int ii = 1; ii <= cnt; ++ii )
+    fLintEngine->clear();
+    fLintItems.clear();
+    fProblemItems.clear();
+    fImpl->problems->clear();
+
+    auto relToDir = doc.relToDir();
+    // duplicate resource paths are loaded as they are, the lint engine reports the collisions
+    // dropping them here would silently delete the entries on the next save
+    for ( auto && prefix : doc.prefixes() )
     {
-        loadPrefix( dir, query, ii );
+        auto prefixItem = addPrefix( prefix.fPrefix, prefix.fLang );
+        for ( auto && file : prefix.fFiles )
+            SFileInfo( file ).addFile( relToDir, prefixItem, false );
+        prefixItem->setExpanded( true );
     }
+    NSABUtils::autoSize( fImpl->files );
 
-    fFileName = fileName;
-    setModified( false, true );
-    return true;
+    fFileName = doc.fileName();
+    lintAll();
 }
 
 void CMainWindow::setFileName( const QString & fileName )
@@ -460,6 +510,7 @@ void CMainWindow::setFileName( const QString & fileName )
             item->setText( 0, relPath );
         }
     }
+    lintAll();
 }
 
 bool CMainWindow::slotSaveAs()
@@ -491,98 +542,202 @@ bool CMainWindow::slotSave()
         if ( !QFile::rename( fFileName, backup ) )
             QMessageBox::warning( this, tr( "Could not backup Resource File" ), tr( "Could not backup Resource File '%1' to '%2' for writing" ).arg( fFileName ).arg( backup ) );
     }
-    auto file = QFile( fFileName );
-    if ( !file.open( QFile::WriteOnly | QFile::Truncate | QFile::Text ) )
+    auto canonical = fImpl->actionCanonicalSave->isChecked();
+    auto doc = canonical ? getDocument().canonicalized() : getDocument();
+    QString msg;
+    if ( !doc.save( fFileName, &msg, canonical ) )
     {
-        QMessageBox::critical( this, tr( "Could not open Resource File" ), tr( "Could not open Resource File '%1' for writing" ).arg( fFileName ) );
+        QMessageBox::critical( this, tr( "Could not save Resource File" ), msg );
         return false;
     }
-    QXmlStreamWriter writer( &file );
-    writer.setAutoFormatting( true );
-    writer.writeStartDocument();
-    writer.writeStartElement( "RCC" );
 
+    if ( fImpl->actionGenerateIndexHeader->isChecked() )
+    {
+        auto headerFile = CQRCIndexGenerator::defaultHeaderFile( fFileName );
+        bool changed = false;
+        if ( !CQRCIndexGenerator( doc ).write( headerFile, &changed, &msg ) )
+            QMessageBox::warning( this, tr( "Could not write Resource Index Header" ), msg );
+        else
+            statusBar()->showMessage( changed ? tr( "Wrote '%1'" ).arg( headerFile ) : tr( "'%1' is up to date" ).arg( headerFile ), 5000 );
+    }
+
+    setModified( false );
+    return true;
+}
+
+CQRCDocument CMainWindow::getDocument() const
+{
+    CQRCDocument retVal( fFileName );
     for ( int ii = 0; ii < fImpl->files->topLevelItemCount(); ++ii )
     {
         auto prefixItem = fImpl->files->topLevelItem( ii );
         if ( !prefixItem )
             continue;
 
-        writer.writeStartElement( "qresource" );
-            if ( !prefixItem->text( 1 ).isEmpty() )
-                writer.writeAttribute( "lang", prefixItem->text( 1 ) );
-            auto prefix = prefixItem->text( 0 );
-            if ( prefix.isEmpty() )
-                prefix = "/";
-            writer.writeAttribute( "prefix", prefix );
+        SQRCPrefix prefix;
+        prefix.fPrefix = prefixItem->text( 0 );
+        if ( prefix.fPrefix.isEmpty() )
+            prefix.fPrefix = "/";
+        prefix.fLang = prefixItem->text( 1 );
 
-            for ( int jj = 0; jj < prefixItem->childCount(); ++jj )
-            {
-                auto fileItem = prefixItem->child( jj );
-                if ( !fileItem )
-                    continue;
+        for ( int jj = 0; jj < prefixItem->childCount(); ++jj )
+        {
+            auto fileItem = prefixItem->child( jj );
+            if ( !fileItem )
+                continue;
 
-                writer.writeStartElement( "file" );
-                    if ( !fileItem->text( 2 ).isEmpty() )
-                        writer.writeAttribute( "alias", fileItem->text( 2 ) );
-
-                    QString algo;
-                    QString threshold;
-                    QString level;
-                    std::tie( algo, threshold, level ) = getCompressionInfo( fileItem );
-
-                    if ( !algo.isEmpty() )
-                    {
-                        writer.writeAttribute( "compress-algo", algo );
-                        if ( !level.isEmpty() )
-                            writer.writeAttribute( "compress", threshold );
-                    }
-                    if ( !threshold.isEmpty() )
-                        writer.writeAttribute( "threshold", threshold );
-                    auto fn = fileItem->text( 0 );
-                    if ( fn.startsWith( "./" ) || fn.startsWith( ".\\" ) )
-                        fn = fn.mid( 2 );
-
-                    writer.writeCharacters( fn );
-                writer.writeEndElement();
-            }
-        writer.writeEndElement();
+            prefix.fFiles.push_back( getFile( fileItem ) );
+        }
+        retVal.prefixes().push_back( prefix );
     }
+    return retVal;
+}
 
-    writer.writeEndElement();
-    writer.writeEndDocument();
+SQRCFile CMainWindow::getFile( QTreeWidgetItem * item ) const
+{
+    SQRCFile retVal;
+    retVal.fFileName = CQRCDocument::normalizedFileName( item->text( 0 ) );
+    retVal.fAlias = item->text( 2 );
+    std::tie( retVal.fAlgo, retVal.fThreshold, retVal.fLevel ) = getCompressionInfo( item );
+    return retVal;
+}
 
-    setModified( false );
-    return true;
+void CMainWindow::lintItem( QTreeWidgetItem * item )
+{
+    if ( !item )
+        return;
+
+    auto id = lintID( item, true );
+    fLintItems[ id ] = item;
+
+    CLintEngine::SEntry entry;
+    auto prefixItem = item->parent() ? item->parent() : item;
+    entry.fPrefix = prefixItem->text( 0 );
+    entry.fLang = prefixItem->text( 1 );
+    if ( !item->parent() )
+    {
+        entry.fIsPrefix = true;
+        fLintEngine->updateEntry( id, entry );
+
+        // the resource paths of the files depend on the prefix
+        for ( int ii = 0; ii < item->childCount(); ++ii )
+            lintItem( item->child( ii ) );
+        return;
+    }
+
+    QDir relToDir;
+    if ( !fFileName.isEmpty() )
+        relToDir = QFileInfo( fFileName ).absoluteDir();
+    entry.fFile = getFile( item );
+    entry.fAbsPath = relToDir.absoluteFilePath( entry.fFile.fFileName );
+    fLintEngine->updateEntry( id, entry );
 }
 
-std::tuple< QString, QString, QString > CMainWindow::getCompressionInfo( QTreeWidgetItem * item ) const
+void CMainWindow::unlintItem( QTreeWidgetItem * item )
 {
     if ( !item )
-        return {};
+        return;
 
-    auto algo = item->text( 4 ).toLower();
-    if ( algo == tr( "none" ) )
-        return std::make_tuple( "none", QString(), QString() );
+    for ( int ii = 0; ii < item->childCount(); ++ii )
+        unlintItem( item->child( ii ) );
 
-    auto threshold = item->text( 6 );
-    if ( threshold == "70" )
-        threshold.clear();
+    auto id = lintID( item, false );
+    if ( !id )
+        return;
+    fLintItems.erase( id );
+    fLintEngine->removeEntry( id );
+
+    auto pos = fProblemItems.find( id );
+    if ( pos != fProblemItems.end() )
+    {
+        qDeleteAll( ( *pos ).second );
+        fProblemItems.erase( pos );
+    }
+}
 
-    auto level = item->text( 5 );
-    if ( algo == "best" )
-        level.clear();
-    else if ( algo == "zstd" )
+quint64 CMainWindow::lintID( QTreeWidgetItem * item, bool create )
+{
+    auto retVal = item->data( 0, Qt::UserRole ).toULongLong();
+    if ( !retVal && create )
     {
-        if ( level == "14" )
-            level.clear();
+        retVal = ++fLastLintID;
+        item->setData( 0, Qt::UserRole, retVal );
     }
-    else if ( algo == "zlib" )
+    return retVal;
+}
+
+void CMainWindow::lintAll()
+{
+    for ( int ii = 0; ii < fImpl->files->topLevelItemCount(); ++ii )
+        lintItem( fImpl->files->topLevelItem( ii ) );
+}
+
+void CMainWindow::slotProblemsChanged( const CLintEngine::TResults & results )
+{
+    fImpl->problems->setUpdatesEnabled( false );
+    for ( auto && ii : results )
     {
-        if ( level == "6" )
-            level.clear();
+        auto pos = fProblemItems.find( ii.fID );
+        if ( pos != fProblemItems.end() )
+        {
+            qDeleteAll( ( *pos ).second );
+            fProblemItems.erase( pos );
+        }
+
+        // removed since it was queued
+        if ( ii.fProblems.isEmpty() || ( fLintItems.find( ii.fID ) == fLintItems.end() ) )
+            continue;
+
+        auto && rows = fProblemItems[ ii.fID ];
+        for ( auto && problem : ii.fProblems )
+        {
+            auto row = new QTreeWidgetItem( fImpl->problems, QStringList() << CLintEngine::toString( problem.fSeverity ) << ii.fResourcePath << problem.fMessage );
+            row->setData( 0, Qt::UserRole, ii.fID );
+            switch ( problem.fSeverity )
+            {
+                case CLintEngine::ESeverity::eError:
+                    row->setIcon( 0, style()->standardIcon( QStyle::SP_MessageBoxCritical ) );
+                    break;
+                case CLintEngine::ESeverity::eWarning:
+                    row->setIcon( 0, style()->standardIcon( QStyle::SP_MessageBoxWarning ) );
+                    break;
+                case CLintEngine::ESeverity::eInfo:
+                    row->setIcon( 0, style()->standardIcon( QStyle::SP_MessageBoxInformation ) );
+                    break;
+            }
+            rows.push_back( row );
+        }
     }
-    return std::make_tuple( algo, threshold, level );
+    fImpl->problems->setUpdatesEnabled( true );
+    fImpl->problemsDock->setWindowTitle( tr( "Problems (%1)" ).arg( fImpl->problems->topLevelItemCount() ) );
+}
+
+void CMainWindow::slotProblemActivated( QTreeWidgetItem * problemItem )
+{
+    if ( !problemItem )
+        return;
+
+    auto pos = fLintItems.find( problemItem->data( 0, Qt::UserRole ).toULongLong() );
+    if ( pos == fLintItems.end() )
+        return;
+
+    fImpl->files->setCurrentItem( ( *pos ).second );
+    fImpl->files->scrollToItem( ( *pos ).second );
+}
+
+std::tuple< QString, QString, QString > CMainWindow::getCompressionInfo( QTreeWidgetItem * item ) const
+{
+    if ( !item )
+        return {};
+
+    SQRCFile file;
+    file.fAlgo = item->text( 4 );
+    if ( file.fAlgo.toLower() == tr( "none" ) )
+        file.fAlgo = "none";
+    file.fLevel = item->text( 5 );
+    file.fThreshold = item->text( 6 );
+    CQRCDocument::normalizeCompression( file );
+    return std::make_tuple( file.fAlgo, file.fThreshold, file.fLevel );
 }
 
 
@@ -591,6 +746,7 @@ void CMainWindow::slotRemove()
     auto curr = fImpl->files->currentItem();
     if ( !curr )
         return;
+    unlintItem( curr );
     delete curr;
     setModified( true );
 }
@@ -627,10 +783,180 @@ void CMainWindow::slotAddPrefix()
     } while ( fPrefixMap.find( prefix ) != fPrefixMap.end() );
 
     auto item = addPrefix( prefix , QString() );
+    lintItem( item );
     fImpl->files->setCurrentItem( item );
     setModified( true );
 }
 
+void CMainWindow::slotPartition()
+{
+    saveToItem( fImpl->files->currentItem() );
+    if ( fFileName.isEmpty() )
+    {
+        QMessageBox::warning( this, tr( "Resource File not Saved" ), tr( "The resource file must be saved before it can be partitioned" ) );
+        return;
+    }
+
+    auto doc = getDocument();
+    CPartitionDlg dlg( doc, this );
+    dlg.exec();
+}
+
+void CMainWindow::slotCompare()
+{
+    saveToItem( fImpl->files->currentItem() );
+
+    auto fn = QFileDialog::getOpenFileName( this, tr( "Choose Resource File to Compare With" ), QString(), tr( "Resource Files (*.qrc)" ) );
+    if ( fn.isEmpty() )
+        return;
+
+    CQRCDocument other;
+    QString msg;
+    if ( !other.load( fn, &msg ) )
+    {
+        QMessageBox::critical( this, tr( "Could not open Resource File" ), msg );
+        return;
+    }
+
+    auto changes = CQRCDiff::diff( other, getDocument() );
+    auto summary = tr( "%1 change(s) from '%2' to the current resource file" ).arg( changes.size() ).arg( fn );
+    CDiffDlg dlg( summary, changes, {}, this );
+    dlg.exec();
+}
+
+void CMainWindow::slotMerge()
+{
+    saveToItem( fImpl->files->currentItem() );
+
+    auto baseFile = QFileDialog::getOpenFileName( this, tr( "Choose Common Base Resource File" ), QString(), tr( "Resource Files (*.qrc)" ) );
+    if ( baseFile.isEmpty() )
+        return;
+    auto theirFile = QFileDialog::getOpenFileName( this, tr( "Choose Resource File to Merge" ), QString(), tr( "Resource Files (*.qrc)" ) );
+    if ( theirFile.isEmpty() )
+        return;
+
+    CQRCDocument base;
+    CQRCDocument theirs;
+    QString msg;
+    if ( !base.load( baseFile, &msg ) || !theirs.load( theirFile, &msg ) )
+    {
+        QMessageBox::critical( this, tr( "Could not open Resource File" ), msg );
+        return;
+    }
+
+    auto ours = getDocument();
+    CQRCDocument merged;
+    std::vector< CQRCDiff::SConflict > conflicts;
+    CQRCDiff::merge( base, ours, theirs, merged, conflicts );
+
+    auto changes = CQRCDiff::diff( ours, merged );
+    setDocument( merged );
+    setModified( true );
+
+    auto summary = tr( "Merged '%1' into the current resource file, %2 change(s) and %3 conflict(s). Conflicts kept the current values." ).arg( theirFile ).arg( changes.size() ).arg( conflicts.size() );
+    CDiffDlg dlg( summary, changes, conflicts, this );
+    dlg.exec();
+}
+
+void CMainWindow::slotOptimizeImages()
+{
+    saveToItem( fImpl->files->currentItem() );
+    if ( fFileName.isEmpty() )
+    {
+        QMessageBox::warning( this, tr( "Resource File not Saved" ), tr( "The resource file must be saved before its images can be optimized" ) );
+        return;
+    }
+
+    // the current file, the files of the current prefix, or everything
+    std::vector< QTreeWidgetItem * > items;
+    auto addItem = [&items]( QTreeWidgetItem * item )
+    {
+        if ( item && CImageOptimizer::isCandidate( item->text( 0 ) ) )
+            items.push_back( item );
+    };
+    auto curr = fImpl->files->currentItem();
+    for ( int ii = 0; ii < fImpl->files->topLevelItemCount(); ++ii )
+    {
+        auto prefixItem = fImpl->files->topLevelItem( ii );
+        if ( !prefixItem || ( curr && ( curr != prefixItem ) && ( curr->parent() != prefixItem ) ) )
+            continue;
+        for ( int jj = 0; jj < prefixItem->childCount(); ++jj )
+        {
+            auto item = prefixItem->child( jj );
+            if ( !curr || ( curr == prefixItem ) || ( curr == item ) )
+                addItem( item );
+        }
+    }
+    if ( items.empty() )
+    {
+        QMessageBox::information( this, tr( "Optimize Images" ), tr( "No PNG images are selected" ) );
+        return;
+    }
+
+    auto relToDir = QFileInfo( fFileName ).absoluteDir();
+    auto cacheDir = QFileDialog::getExistingDirectory( this, tr( "Select Optimized Image Cache Directory" ), relToDir.absolutePath() );
+    if ( cacheDir.isEmpty() )
+        return;
+
+    std::vector< CImageOptimizer::SJob > jobs;
+    for ( auto && ii : items )
+    {
+        auto threshold = ii->text( 6 );
+        jobs.push_back( { relToDir.absoluteFilePath( ii->text( 0 ) ), cacheDir, threshold.isEmpty() ? 70 : threshold.toInt() } );
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QProgressDialog progress( tr( "Optimizing images..." ), tr( "Cancel" ), 0, static_cast< int >( jobs.size() ), this );
+    progress.setWindowModality( Qt::WindowModal );
+    QFutureWatcher< CImageOptimizer::SResult > watcher;
+    connect( &watcher, &QFutureWatcherBase::progressValueChanged, &progress, &QProgressDialog::setValue );
+    connect( &watcher, &QFutureWatcherBase::finished, &progress, &QProgressDialog::reset );
+    connect( &progress, &QProgressDialog::canceled, &watcher, &QFutureWatcherBase::cancel );
+    watcher.setFuture( CImageOptimizer::start( jobs ) );
+    progress.exec();
+    watcher.waitForFinished();
+
+    CImageOptimizer::SReport report;
+    report.fElapsedMS = timer.elapsed();
+
+    bool changed = false;
+    for ( size_t ii = 0; ii < items.size(); ++ii )
+    {
+        if ( !watcher.future().isResultReadyAt( static_cast< int >( ii ) ) )
+            continue;
+        auto result = watcher.future().resultAt( static_cast< int >( ii ) );
+        report.fResults.push_back( result );
+
+        auto item = items[ ii ];
+        SQRCFile file;
+        file.fFileName = CQRCDocument::normalizedFileName( item->text( 0 ) );
+        file.fAlias = item->text( 2 );
+        file.fAlgo = item->text( 4 );
+        file.fLevel = item->text( 5 );
+        file.fThreshold = item->text( 6 );
+        if ( !CImageOptimizer::apply( result, relToDir, file ) )
+            continue;
+
+        item->setText( 0, QString( "./%1" ).arg( file.fFileName ) );
+        item->setText( 2, file.fAlias );
+        item->setText( 3, NSABUtils::NFileUtils::fileSizeString( QFileInfo( relToDir.absoluteFilePath( file.fFileName ) ) ) );
+        item->setText( 4, file.fAlgo );
+        item->setText( 5, file.fLevel );
+        item->setText( 6, file.fThreshold );
+        lintItem( item );
+        changed = true;
+    }
+
+    if ( changed )
+    {
+        loadFromItem( fImpl->files->currentItem() );
+        setModified( true );
+    }
+    QMessageBox::information( this, tr( "Optimize Images" ), report.toString() );
+}
+
 void CMainWindow::closeEvent( QCloseEvent * event )
 {
     if ( !canSave() )
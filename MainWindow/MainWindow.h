@@ -23,18 +23,21 @@
 #ifndef _MAINWINDOW_H
 #define _MAINWINDOW_H
 
+#include "LintEngine.h"
+#include "PreviewLoader.h"
+
 #include <QMainWindow>
 #include <tuple>
 
 class QDir;
-class QXmlItem;
-class QXmlQuery;
 class QTreeWidgetItem;
 namespace Ui
 {
     class CMainWindow;
 }
 struct SFileInfo;
+struct SQRCFile;
+class CQRCDocument;
 class CMainWindow : public QMainWindow
 {
     Q_OBJECT
@@ -55,9 +58,16 @@ public Q_SLOTS:
     void slotRemove();
     void slotAddFiles();
     void slotAddPrefix();
+    void slotPartition();
+    void slotCompare();
+    void slotMerge();
+    void slotOptimizeImages();
 
     void slotItemChanged( QTreeWidgetItem * current, QTreeWidgetItem * previous );
     void slotCompAlgoChanged( const QString & algo );
+    void slotProblemsChanged( const CLintEngine::TResults & results );
+    void slotProblemActivated( QTreeWidgetItem * problemItem );
+    void slotPreviewReady( const CPreviewLoader::SPreview & preview );
 Q_SIGNALS:
 private:
     void setFileName( const QString & fileName );
@@ -66,7 +76,7 @@ private:
     bool set( QTreeWidgetItem * item, int column, int newValue, int blankValue = -1 );
     void loadFromItem( QTreeWidgetItem * item );
     void saveToItem( QTreeWidgetItem * item );
-    void loadPrefix( const QDir & relToDir, QXmlQuery & query, int pos );
+    void setDocument( const CQRCDocument & doc );
     void loadFile( const QDir & relToDir, const QString & prefix, const QString & lang, const SFileInfo & fileInfo );
     void loadFile( const QDir & relToDir, const QString & prefix, const QString & lang, const QString & path );
 
@@ -75,6 +85,20 @@ private:
 
     QTreeWidgetItem * addPrefix( const QString & prefix, const QString & lang );
 
+    // the current state of the tree
+    CQRCDocument getDocument() const;
+    SQRCFile getFile( QTreeWidgetItem * item ) const;
+
+    // queues the item, and for a prefix its files, for a background re-check
+    void lintItem( QTreeWidgetItem * item );
+    void unlintItem( QTreeWidgetItem * item );
+    // stored on the item, never reused so results queued for a deleted item can not match a new one
+    quint64 lintID( QTreeWidgetItem * item, bool create );
+    void lintAll();
+
+    void updatePreview( QTreeWidgetItem * item );
+    void showPreview( const CPreviewLoader::SPreview & preview );
+
     bool canSave();
     std::unique_ptr< Ui::CMainWindow > fImpl;
 
@@ -84,5 +108,13 @@ private:
     int fDefaultCompLevel{ -1 };
 
     std::unordered_map< QString, std::unordered_map< QString, QTreeWidgetItem * > > fPrefixMap;
+
+    std::unique_ptr< CLintEngine > fLintEngine;
+    quint64 fLastLintID{ 0 };
+    std::unordered_map< quint64, QTreeWidgetItem * > fLintItems; // lint id -> file or prefix item
+    std::unordered_map< quint64, std::vector< QTreeWidgetItem * > > fProblemItems; // lint id -> rows in the problems list
+
+    std::unique_ptr< CPreviewLoader > fPreviewLoader;
+    QString fPreviewPath;
 };
 #endif 
@@ -0,0 +1,106 @@
+// The MIT License( MIT )
+//
+// Copyright( c ) 2020-2021 Scott Aron Bloom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "PartitionDlg.h"
+#include "QRCPartitioner.h"
+
+#include "ui_PartitionDlg.h"
+
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QFileInfo>
+
+CPartitionDlg::CPartitionDlg( const CQRCDocument & doc, QWidget * parent )
+    : QDialog( parent ),
+    fImpl( new Ui::CPartitionDlg ),
+    fDocument( doc )
+{
+    fImpl->setupUi( this );
+
+    fImpl->outputDir->setText( doc.relToDir().absolutePath() );
+    fImpl->baseName->setText( QFileInfo( doc.fileName() ).completeBaseName() );
+    fImpl->compileShards->setEnabled( !CQRCPartitioner::rccExecutable().isEmpty() );
+    fImpl->compileShards->setChecked( fImpl->compileShards->isEnabled() );
+
+    connect( fImpl->strategy, static_cast< void ( QComboBox::* )( int ) >( &QComboBox::currentIndexChanged ), this, &CPartitionDlg::slotStrategyChanged );
+    connect( fImpl->usageFileBtn, &QToolButton::clicked, this, &CPartitionDlg::slotSelectUsageFile );
+    connect( fImpl->outputDirBtn, &QToolButton::clicked, this, &CPartitionDlg::slotSelectOutputDir );
+
+    slotStrategyChanged();
+}
+
+CPartitionDlg::~CPartitionDlg()
+{
+}
+
+void CPartitionDlg::slotStrategyChanged()
+{
+    auto byUsage = fImpl->strategy->currentIndex() == static_cast< int >( CQRCPartitioner::EStrategy::eByUsage );
+    fImpl->usageFile->setEnabled( byUsage );
+    fImpl->usageFileBtn->setEnabled( byUsage );
+    fImpl->coreBudget->setEnabled( !byUsage );
+}
+
+void CPartitionDlg::slotSelectUsageFile()
+{
+    auto fn = QFileDialog::getOpenFileName( this, tr( "Select Usage File" ), fImpl->usageFile->text(), tr( "Text Files (*.txt);;All Files (*)" ) );
+    if ( fn.isEmpty() )
+        return;
+    fImpl->usageFile->setText( fn );
+}
+
+void CPartitionDlg::slotSelectOutputDir()
+{
+    auto dir = QFileDialog::getExistingDirectory( this, tr( "Select Output Directory" ), fImpl->outputDir->text() );
+    if ( dir.isEmpty() )
+        return;
+    fImpl->outputDir->setText( dir );
+}
+
+void CPartitionDlg::accept()
+{
+    CQRCPartitioner partitioner( fDocument );
+    auto strategy = static_cast< CQRCPartitioner::EStrategy >( fImpl->strategy->currentIndex() );
+    partitioner.setStrategy( strategy );
+    partitioner.setCoreBudget( static_cast< qint64 >( fImpl->coreBudget->value() ) * 1024 );
+    partitioner.setShardBudget( static_cast< qint64 >( fImpl->shardBudget->value() ) * 1024 );
+    partitioner.setOutputDir( fImpl->outputDir->text() );
+    partitioner.setBaseName( fImpl->baseName->text() );
+    partitioner.setCompileShards( fImpl->compileShards->isChecked() );
+
+    QString msg;
+    if ( strategy == CQRCPartitioner::EStrategy::eByUsage && !partitioner.setUsageFile( fImpl->usageFile->text(), &msg ) )
+    {
+        QMessageBox::critical( this, tr( "Could not Partition Resource File" ), msg );
+        return;
+    }
+
+    CQRCPartitioner::SReport report;
+    if ( !partitioner.run( report, &msg ) )
+    {
+        QMessageBox::critical( this, tr( "Could not Partition Resource File" ), msg );
+        return;
+    }
+
+    QMessageBox::information( this, tr( "Partition Report" ), report.toString() );
+    QDialog::accept();
+}
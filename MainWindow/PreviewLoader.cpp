@@ -0,0 +1,198 @@
+// The MIT License( MIT )
+//
+// Copyright( c ) 2020-2021 Scott Aron Bloom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "PreviewLoader.h"
+
+#include <QtConcurrent>
+#include <QBuffer>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QLocale>
+#include <QPainter>
+#include <QSvgRenderer>
+
+#include <algorithm>
+#include <limits>
+
+static const int kCacheBytes = 32 * 1024 * 1024;
+// readers that can not decode at a smaller size (PNG) decode the full image first, at 4 bytes per pixel
+// this bounds each worker to 32 MB
+static const qint64 kMaxPixels = 8 * 1024 * 1024;
+static const int kMaxTextBytes = 64 * 1024;
+
+CPreviewLoader::CPreviewLoader( QObject * parent ) :
+    QObject( parent )
+{
+    fPool.setMaxThreadCount( 2 );
+    fCache.setMaxCost( kCacheBytes );
+}
+
+CPreviewLoader::~CPreviewLoader()
+{
+    cancel();
+    fPool.waitForDone();
+}
+
+QSize CPreviewLoader::thumbnailSize()
+{
+    return QSize( 256, 256 );
+}
+
+int CPreviewLoader::SPreview::cost() const
+{
+    return static_cast< int >( fImage.sizeInBytes() ) + ( fText.size() + fInfo.size() ) * static_cast< int >( sizeof( QChar ) ) + 1;
+}
+
+void CPreviewLoader::cancel()
+{
+    ++fGeneration;
+    fPool.clear();
+}
+
+void CPreviewLoader::request( const QString & path )
+{
+    cancel();
+    quint64 generation = fGeneration;
+
+    auto fi = QFileInfo( path );
+    if ( !fi.isFile() )
+    {
+        SPreview preview;
+        preview.fPath = path;
+        preview.fInfo = tr( "File does not exist" );
+        emit sigPreviewReady( preview );
+        return;
+    }
+
+    // a changed file gets a new key, the stale entry ages out
+    auto key = QString( "%1\n%2\n%3" ).arg( fi.absoluteFilePath() ).arg( fi.size() ).arg( fi.lastModified().toMSecsSinceEpoch() );
+    if ( auto cached = fCache.object( key ) )
+    {
+        // the entry may have been decoded through a different spelling of the path
+        auto preview = *cached;
+        preview.fPath = path;
+        emit sigPreviewReady( preview );
+        return;
+    }
+
+    QtConcurrent::run( &fPool,
+                       [this, path, key, generation]()
+                       {
+                           if ( fGeneration != generation )
+                               return;
+                           auto preview = decode( path );
+                           if ( fGeneration != generation )
+                               return;
+                           QMetaObject::invokeMethod( this, [this, key, generation, preview]() { decoded( key, generation, preview ); }, Qt::QueuedConnection );
+                       } );
+}
+
+void CPreviewLoader::decoded( const QString & key, quint64 generation, const SPreview & preview )
+{
+    fCache.insert( key, new SPreview( preview ), preview.cost() );
+    if ( generation == fGeneration )
+        emit sigPreviewReady( preview );
+}
+
+CPreviewLoader::SPreview CPreviewLoader::decode( const QString & path )
+{
+    QLocale locale;
+    SPreview retVal;
+    retVal.fPath = path;
+
+    QFile file( path );
+    if ( !file.open( QFile::ReadOnly ) )
+    {
+        retVal.fInfo = tr( "Could not open file" );
+        return retVal;
+    }
+
+    // map rather than read, only the pages the decoder touches are loaded
+    auto fileSize = file.size();
+    auto mapSize = std::min< qint64 >( fileSize, std::numeric_limits< int >::max() );
+    auto mapped = ( mapSize > 0 ) ? file.map( 0, mapSize ) : nullptr;
+    auto data = mapped ? QByteArray::fromRawData( reinterpret_cast< const char * >( mapped ), static_cast< int >( mapSize ) ) : file.read( mapSize );
+
+    // rendered directly, so it does not depend on the svg image format plugin being deployed
+    auto suffix = QFileInfo( path ).suffix().toLower();
+    if ( ( suffix == "svg" ) || ( suffix == "svgz" ) )
+    {
+        QSvgRenderer renderer( data );
+        if ( renderer.isValid() )
+        {
+            auto svgSize = renderer.defaultSize();
+            retVal.fInfo = tr( "SVG image, %1 x %2, %3" ).arg( svgSize.width() ).arg( svgSize.height() ).arg( locale.formattedDataSize( fileSize ) );
+
+            auto imageSize = svgSize.isEmpty() ? thumbnailSize() : svgSize;
+            if ( ( imageSize.width() > thumbnailSize().width() ) || ( imageSize.height() > thumbnailSize().height() ) )
+                imageSize = imageSize.scaled( thumbnailSize(), Qt::KeepAspectRatio );
+            retVal.fImage = QImage( imageSize, QImage::Format_ARGB32_Premultiplied );
+            retVal.fImage.fill( Qt::transparent );
+            {
+                QPainter painter( &retVal.fImage );
+                renderer.render( &painter );
+            }
+            return retVal;
+        }
+    }
+
+    QBuffer buffer( &data );
+    buffer.open( QBuffer::ReadOnly );
+    QImageReader reader( &buffer );
+    if ( reader.canRead() )
+    {
+        auto format = QString::fromLatin1( reader.format() ).toUpper();
+        auto imageSize = reader.size();
+        // both the pixel cap and the thumbnail scaling need the size, without it the image would be decoded at full size
+        // the cap only matters when the reader decodes at full size before scaling
+        auto scalesWhileDecoding = reader.supportsOption( QImageIOHandler::ScaledSize );
+        if ( !imageSize.isValid() )
+            retVal.fInfo = tr( "%1 image, unknown size, %2 - can not preview" ).arg( format ).arg( locale.formattedDataSize( fileSize ) );
+        else if ( !scalesWhileDecoding && ( static_cast< qint64 >( imageSize.width() ) * imageSize.height() > kMaxPixels ) )
+            retVal.fInfo = tr( "%1 image, %2 x %3, %4 - too large to preview" ).arg( format ).arg( imageSize.width() ).arg( imageSize.height() ).arg( locale.formattedDataSize( fileSize ) );
+        else
+        {
+            retVal.fInfo = tr( "%1 image, %2 x %3, %4" ).arg( format ).arg( imageSize.width() ).arg( imageSize.height() ).arg( locale.formattedDataSize( fileSize ) );
+            if ( ( imageSize.width() > thumbnailSize().width() ) || ( imageSize.height() > thumbnailSize().height() ) )
+                reader.setScaledSize( imageSize.scaled( thumbnailSize(), Qt::KeepAspectRatio ) );
+            retVal.fImage = reader.read();
+            if ( retVal.fImage.isNull() )
+                retVal.fInfo += QString( " - %1" ).arg( reader.errorString() );
+        }
+    }
+    else
+    {
+        auto head = data.left( kMaxTextBytes ); // copies, so nothing refers to the mapping once the file closes
+        if ( head.contains( '\0' ) )
+            retVal.fInfo = tr( "Binary file, %1" ).arg( locale.formattedDataSize( fileSize ) );
+        else
+        {
+            retVal.fText = QString::fromUtf8( head );
+            retVal.fInfo = tr( "Text file, %1" ).arg( locale.formattedDataSize( fileSize ) );
+            if ( fileSize > kMaxTextBytes )
+                retVal.fInfo += tr( ", showing the first %1" ).arg( locale.formattedDataSize( kMaxTextBytes ) );
+        }
+    }
+    return retVal;
+}
@@ -0,0 +1,71 @@
+// The MIT License( MIT )
+//
+// Copyright( c ) 2020-2021 Scott Aron Bloom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _PREVIEWLOADER_H
+#define _PREVIEWLOADER_H
+
+#include <QObject>
+#include <QCache>
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+#include <atomic>
+
+// Decodes previews of resource files on a small thread pool, reading from memory mapped files.
+// SVGs are rendered at thumbnail size and images are scaled to it. Readers that can not decode at a smaller
+// size (PNG) decode the full image first, so those are only previewed up to a pixel limit. Text is limited to its first block.
+// Finished previews are kept in a cost bounded LRU cache, and requests superseded by a newer
+// one are dropped before they start or before their result is delivered
+class CPreviewLoader : public QObject
+{
+    Q_OBJECT
+public:
+    struct SPreview
+    {
+        QString fPath;
+        QImage fImage;
+        QString fText;
+        QString fInfo;
+
+        int cost() const;
+    };
+
+    CPreviewLoader( QObject * parent = nullptr );
+    virtual ~CPreviewLoader() override;
+
+    // the result is delivered by sigPreviewReady, immediately when cached
+    void request( const QString & path );
+    void cancel();
+
+    static QSize thumbnailSize();
+Q_SIGNALS:
+    void sigPreviewReady( const CPreviewLoader::SPreview & preview );
+private:
+    static SPreview decode( const QString & path );
+    void decoded( const QString & key, quint64 generation, const SPreview & preview );
+
+    QThreadPool fPool;
+    std::atomic< quint64 > fGeneration{ 0 };
+    QCache< QString, SPreview > fCache;
+};
+#endif
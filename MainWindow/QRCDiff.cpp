@@ -0,0 +1,272 @@
+// The MIT License( MIT )
+//
+// Copyright( c ) 2020-2021 Scott Aron Bloom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "QRCDiff.h"
+
+#include <QObject>
+
+#include <unordered_map>
+#include <unordered_set>
+
+struct SAttribute
+{
+    const char * fName;
+    QString SQRCFile::*fMember;
+};
+
+static const SAttribute kAttributes[] =
+{
+    { "file", &SQRCFile::fFileName },
+    { "alias", &SQRCFile::fAlias },
+    { "compress-algo", &SQRCFile::fAlgo },
+    { "compress", &SQRCFile::fLevel },
+    { "threshold", &SQRCFile::fThreshold }
+};
+
+QStringList changedAttributes( const SQRCFile & from, const SQRCFile & to )
+{
+    QStringList retVal;
+    for ( auto && ii : kAttributes )
+    {
+        if ( from.*ii.fMember != to.*ii.fMember )
+            retVal << QString( "%1: '%2' -> '%3'" ).arg( ii.fName ).arg( from.*ii.fMember ).arg( to.*ii.fMember );
+    }
+    return retVal;
+}
+
+QString CQRCDiff::SEntry::resourcePath() const
+{
+    return CQRCDocument::resourcePath( fPrefix, fResourceName );
+}
+
+SQRCFile CQRCDiff::SEntry::resultFile() const
+{
+    auto retVal = fFile;
+    if ( retVal.fAlias.isEmpty() && ( CQRCDocument::normalizedFileName( retVal.fFileName ) != fResourceName ) )
+        retVal.fAlias = fResourceName;
+    return retVal;
+}
+
+QString CQRCDiff::SEntry::key() const
+{
+    return fLang + '\n' + resourcePath();
+}
+
+QString CQRCDiff::SChange::toString() const
+{
+    auto && entry = ( fType == EChange::eRemoved ) ? fOld : fNew;
+    auto retVal = entry.resourcePath();
+    if ( !entry.fLang.isEmpty() )
+        retVal += QString( " [%1]" ).arg( entry.fLang );
+
+    switch ( fType )
+    {
+        case EChange::eAdded:
+            return "+ " + retVal;
+        case EChange::eRemoved:
+            return "- " + retVal;
+        case EChange::eChanged:
+            return QString( "~ %1 (%2)" ).arg( retVal ).arg( fAttributes.join( ", " ) );
+    }
+    return retVal;
+}
+
+// file names relative to relTo's directory, keys from the resource paths doc registers
+std::vector< CQRCDiff::SEntry > CQRCDiff::entries( const CQRCDocument & doc, const CQRCDocument & relTo )
+{
+    auto relToDir = relTo.relToDir();
+    auto rebase = doc.relToDir() != relToDir;
+
+    std::vector< SEntry > retVal;
+    for ( auto && prefix : doc.prefixes() )
+    {
+        for ( auto && file : prefix.fFiles )
+        {
+            // a loaded file keeps the values as written, the GUI strips the rcc defaults
+            SEntry entry{ prefix.fPrefix, prefix.fLang, file, file.resourceName() };
+            CQRCDocument::normalizeCompression( entry.fFile );
+            if ( rebase )
+            {
+                entry.fFile.fFileName = doc.relativeFileName( file, relToDir );
+                // an alias pinned by an earlier rebase is redundant once the file name matches it again
+                if ( entry.fFile.fAlias == entry.fFile.fFileName )
+                    entry.fFile.fAlias.clear();
+            }
+            retVal.push_back( entry );
+        }
+    }
+    return retVal;
+}
+
+// first occurrence wins, rcc ignores later duplicates as well
+std::unordered_map< QString, size_t > keyMap( const std::vector< CQRCDiff::SEntry > & entries )
+{
+    std::unordered_map< QString, size_t > retVal;
+    retVal.reserve( entries.size() );
+    for ( size_t ii = 0; ii < entries.size(); ++ii )
+        retVal.insert( { entries[ ii ].key(), ii } );
+    return retVal;
+}
+
+std::vector< CQRCDiff::SChange > CQRCDiff::diff( const CQRCDocument & from, const CQRCDocument & to )
+{
+    // file names are compared as seen from "to"
+    auto fromEntries = entries( from, to );
+    auto toEntries = entries( to, to );
+    auto fromMap = keyMap( fromEntries );
+
+    std::vector< SChange > retVal;
+    std::vector< bool > matched( fromEntries.size(), false );
+    std::unordered_set< QString > seen;
+    for ( auto && ii : toEntries )
+    {
+        auto key = ii.key();
+        if ( !seen.insert( key ).second )
+            continue;
+
+        auto pos = fromMap.find( key );
+        if ( pos == fromMap.end() )
+        {
+            SChange change;
+            change.fType = EChange::eAdded;
+            change.fNew = ii;
+            retVal.push_back( change );
+            continue;
+        }
+
+        matched[ ( *pos ).second ] = true;
+        auto && old = fromEntries[ ( *pos ).second ];
+        auto attributes = changedAttributes( old.fFile, ii.fFile );
+        if ( attributes.isEmpty() )
+            continue;
+
+        SChange change;
+        change.fType = EChange::eChanged;
+        change.fOld = old;
+        change.fNew = ii;
+        change.fAttributes = attributes;
+        retVal.push_back( change );
+    }
+
+    for ( size_t ii = 0; ii < fromEntries.size(); ++ii )
+    {
+        if ( matched[ ii ] || ( fromMap[ fromEntries[ ii ].key() ] != ii ) )
+            continue;
+        SChange change;
+        change.fType = EChange::eRemoved;
+        change.fOld = fromEntries[ ii ];
+        retVal.push_back( change );
+    }
+    return retVal;
+}
+
+bool CQRCDiff::merge( const CQRCDocument & base, const CQRCDocument & ours, const CQRCDocument & theirs, CQRCDocument & result, std::vector< SConflict > & conflicts )
+{
+    conflicts.clear();
+
+    // the result is ours, so file names taken from base or theirs must be relative to it
+    auto baseEntries = entries( base, ours );
+    auto ourEntries = entries( ours, ours );
+    auto theirEntries = entries( theirs, ours );
+    auto baseMap = keyMap( baseEntries );
+    auto ourMap = keyMap( ourEntries );
+    auto theirMap = keyMap( theirEntries );
+
+    result = CQRCDocument( ours.fileName() );
+    std::unordered_map< QString, size_t > prefixPos;
+    auto prefixFor = [&result, &prefixPos]( const QString & prefix, const QString & lang ) -> SQRCPrefix &
+    {
+        auto key = CQRCDocument::normalizedPrefix( prefix ) + '\n' + lang;
+        auto pos = prefixPos.find( key );
+        if ( pos == prefixPos.end() )
+        {
+            pos = prefixPos.insert( { key, result.prefixes().size() } ).first;
+            result.prefixes().push_back( { prefix, lang, {} } );
+        }
+        return result.prefixes()[ ( *pos ).second ];
+    };
+
+    // keep our layout, including empty prefixes
+    for ( auto && ii : ours.prefixes() )
+        prefixFor( ii.fPrefix, ii.fLang );
+
+    auto add = [&prefixFor]( const SEntry & entry ) { prefixFor( entry.fPrefix, entry.fLang ).fFiles.push_back( entry.resultFile() ); };
+    auto conflict = [&conflicts]( const SEntry & entry, const QString & description ) { conflicts.push_back( { entry, QString( "%1: %2" ).arg( entry.resourcePath() ).arg( description ) } ); };
+
+    for ( size_t ii = 0; ii < ourEntries.size(); ++ii )
+    {
+        auto && our = ourEntries[ ii ];
+        auto key = our.key();
+        if ( ourMap[ key ] != ii )
+            continue;
+
+        auto basePos = baseMap.find( key );
+        auto theirPos = theirMap.find( key );
+        if ( theirPos == theirMap.end() )
+        {
+            if ( basePos == baseMap.end() )
+                add( our ); // added by us
+            else if ( !changedAttributes( baseEntries[ ( *basePos ).second ].fFile, our.fFile ).isEmpty() )
+            {
+                conflict( our, QObject::tr( "modified in ours, removed in theirs" ) );
+                add( our );
+            }
+            // else removed by them
+            continue;
+        }
+
+        // in both, merge attribute by attribute, an entry added on both sides merges against an empty base
+        auto && their = theirEntries[ ( *theirPos ).second ];
+        auto baseFile = ( basePos == baseMap.end() ) ? SQRCFile() : baseEntries[ ( *basePos ).second ].fFile;
+        auto merged = our;
+        for ( auto && attr : kAttributes )
+        {
+            auto && baseValue = baseFile.*attr.fMember;
+            auto && ourValue = our.fFile.*attr.fMember;
+            auto && theirValue = their.fFile.*attr.fMember;
+            if ( ( ourValue == theirValue ) || ( theirValue == baseValue ) )
+                continue;
+            if ( ourValue == baseValue )
+                merged.fFile.*attr.fMember = theirValue;
+            else
+                conflict( our, QObject::tr( "%1 is '%2' in ours and '%3' in theirs" ).arg( attr.fName ).arg( ourValue ).arg( theirValue ) );
+        }
+        add( merged );
+    }
+
+    for ( size_t ii = 0; ii < theirEntries.size(); ++ii )
+    {
+        auto && their = theirEntries[ ii ];
+        auto key = their.key();
+        if ( ( theirMap[ key ] != ii ) || ( ourMap.find( key ) != ourMap.end() ) )
+            continue;
+
+        auto basePos = baseMap.find( key );
+        if ( basePos == baseMap.end() )
+            add( their ); // added by them
+        else if ( !changedAttributes( baseEntries[ ( *basePos ).second ].fFile, their.fFile ).isEmpty() )
+            conflict( their, QObject::tr( "removed in ours, modified in theirs" ) );
+        // else removed by us
+    }
+
+    return conflicts.empty();
+}
@@ -0,0 +1,83 @@
+// The MIT License( MIT )
+//
+// Copyright( c ) 2020-2021 Scott Aron Bloom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _QRCDIFF_H
+#define _QRCDIFF_H
+
+#include "QRCDocument.h"
+
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+// Structural comparison of resource files, entries are keyed by language and resource path (prefix plus alias or file name)
+// Both the diff and the merge are linear in the number of entries
+// File names are compared relative to the directory of "to" (diff) or "ours" (merge), so the documents may live in different directories
+class CQRCDiff
+{
+public:
+    enum class EChange
+    {
+        eAdded,
+        eRemoved,
+        eChanged
+    };
+
+    struct SEntry
+    {
+        QString fPrefix;
+        QString fLang;
+        SQRCFile fFile; // the file name is relative to the document compared against
+        QString fResourceName; // as registered by the entry's own document, rebasing the file name does not change the key
+
+        QString key() const;
+        QString resourcePath() const;
+        // fFile with the alias pinned when its file name alone would register a different resource path
+        SQRCFile resultFile() const;
+    };
+
+    struct SChange
+    {
+        EChange fType{ EChange::eChanged };
+        SEntry fOld; // unset when added
+        SEntry fNew; // unset when removed
+        QStringList fAttributes; // changed attributes, "name: old -> new"
+
+        QString toString() const;
+    };
+
+    struct SConflict
+    {
+        SEntry fEntry; // the resolution used, ours
+        QString fDescription;
+    };
+
+    // changes needed to go from "from" to "to"
+    static std::vector< SChange > diff( const CQRCDocument & from, const CQRCDocument & to );
+
+    // non-overlapping changes, including different attributes of the same entry, are resolved automatically
+    // conflicts keep ours and are reported, returns false if there were any
+    static bool merge( const CQRCDocument & base, const CQRCDocument & ours, const CQRCDocument & theirs, CQRCDocument & result, std::vector< SConflict > & conflicts );
+private:
+    static std::vector< SEntry > entries( const CQRCDocument & doc, const CQRCDocument & relTo );
+};
+#endif
@@ -0,0 +1,297 @@
+// The MIT License( MIT )
+//
+// Copyright( c ) 2020-2021 Scott Aron Bloom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "QRCDocument.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+
+#include <algorithm>
+#include <map>
+
+QString SQRCFile::resourceName() const
+{
+    if ( !fAlias.isEmpty() )
+        return fAlias;
+    return CQRCDocument::normalizedFileName( fFileName );
+}
+
+CQRCDocument::CQRCDocument( const QString & fileName ) :
+    fFileName( fileName )
+{
+}
+
+QDir CQRCDocument::relToDir() const
+{
+    if ( fFileName.isEmpty() )
+        return QDir();
+    return QFileInfo( fFileName ).absoluteDir();
+}
+
+CQRCDocument CQRCDocument::rebased( const QString & fileName ) const
+{
+    auto retVal = *this;
+    retVal.fFileName = fileName;
+
+    auto oldRelToDir = relToDir();
+    auto newRelToDir = retVal.relToDir();
+    if ( oldRelToDir == newRelToDir )
+        return retVal;
+
+    for ( auto && prefix : retVal.fPrefixes )
+    {
+        for ( auto && file : prefix.fFiles )
+        {
+            auto resourceName = file.resourceName();
+            file.fFileName = relativeFileName( file, newRelToDir );
+            if ( file.fAlias.isEmpty() && ( file.fFileName != resourceName ) )
+                file.fAlias = resourceName;
+        }
+    }
+    return retVal;
+}
+
+QString CQRCDocument::relativeFileName( const SQRCFile & file, const QDir & dir ) const
+{
+    return normalizedFileName( dir.relativeFilePath( absoluteFilePath( file ) ) );
+}
+
+QString CQRCDocument::absoluteFilePath( const SQRCFile & file ) const
+{
+    return relToDir().absoluteFilePath( file.fFileName );
+}
+
+QString CQRCDocument::normalizedFileName( const QString & fileName )
+{
+    auto retVal = fileName;
+    if ( retVal.startsWith( "./" ) || retVal.startsWith( ".\\" ) )
+        retVal = retVal.mid( 2 );
+    return retVal;
+}
+
+void CQRCDocument::normalizeCompression( SQRCFile & file )
+{
+    file.fAlgo = file.fAlgo.trimmed().toLower();
+    file.fLevel = file.fLevel.trimmed();
+    file.fThreshold = file.fThreshold.trimmed();
+
+    if ( file.fAlgo == "none" )
+    {
+        file.fLevel.clear();
+        file.fThreshold.clear();
+        return;
+    }
+
+    if ( file.fThreshold == "70" )
+        file.fThreshold.clear();
+
+    if ( file.fAlgo == "best" )
+        file.fAlgo.clear();
+
+    if ( file.fAlgo.isEmpty() )
+        file.fLevel.clear();
+    else if ( ( file.fAlgo == "zstd" ) && ( file.fLevel == "14" ) )
+        file.fLevel.clear();
+    else if ( ( file.fAlgo == "zlib" ) && ( file.fLevel == "6" ) )
+        file.fLevel.clear();
+}
+
+QString CQRCDocument::normalizedPrefix( const QString & prefix )
+{
+    // same rules rcc uses
+    auto retVal = prefix;
+    if ( !retVal.startsWith( '/' ) )
+        retVal.prepend( '/' );
+    if ( !retVal.endsWith( '/' ) )
+        retVal.append( '/' );
+    return retVal;
+}
+
+QString CQRCDocument::resourcePath( const QString & prefix, const QString & resourceName )
+{
+    // same rules rcc uses, the name is cleaned on its own and can not climb out of the prefix
+    auto name = QDir::cleanPath( resourceName );
+    while ( name.startsWith( "../" ) )
+        name.remove( 0, 3 );
+    return QString( ":%1" ).arg( QDir::cleanPath( normalizedPrefix( prefix ) + name ) );
+}
+
+QString CQRCDocument::resourcePath( const QString & prefix, const SQRCFile & file )
+{
+    return resourcePath( prefix, file.resourceName() );
+}
+
+bool CQRCDocument::load( const QString & fileName, QString * errorMsg )
+{
+    fPrefixes.clear();
+    fFileName = fileName;
+
+    QFile file( fileName );
+    if ( !file.open( QFile::ReadOnly | QFile::Text ) )
+    {
+        if ( errorMsg )
+            *errorMsg = QObject::tr( "Could not open Resource File '%1'" ).arg( fileName );
+        return false;
+    }
+
+    // single pass, the tree is only RCC/qresource/file
+    QXmlStreamReader reader( &file );
+    while ( !reader.atEnd() )
+    {
+        if ( reader.readNext() != QXmlStreamReader::StartElement )
+            continue;
+
+        auto attribs = reader.attributes();
+        if ( reader.name() == QLatin1String( "qresource" ) )
+        {
+            SQRCPrefix prefix;
+            prefix.fPrefix = attribs.value( "prefix" ).toString();
+            if ( prefix.fPrefix.isEmpty() )
+                prefix.fPrefix = "/";
+            prefix.fLang = attribs.value( "lang" ).toString();
+            fPrefixes.push_back( prefix );
+        }
+        else if ( ( reader.name() == QLatin1String( "file" ) ) && !fPrefixes.empty() )
+        {
+            SQRCFile curr;
+            curr.fAlias = attribs.value( "alias" ).toString();
+            curr.fAlgo = attribs.value( "compress-algo" ).toString();
+            curr.fLevel = attribs.value( "compress" ).toString();
+            curr.fThreshold = attribs.value( "threshold" ).toString();
+            curr.fFileName = normalizedFileName( reader.readElementText().trimmed() );
+            fPrefixes.back().fFiles.push_back( curr );
+        }
+    }
+
+    if ( reader.hasError() )
+    {
+        if ( errorMsg )
+            *errorMsg = QObject::tr( "Error reading Resource File '%1' at line %2: %3" ).arg( fileName ).arg( reader.lineNumber() ).arg( reader.errorString() );
+        return false;
+    }
+    return true;
+}
+
+CQRCDocument CQRCDocument::canonicalized() const
+{
+    std::map< std::pair< QString, QString >, SQRCPrefix > prefixes;
+    for ( auto && prefix : fPrefixes )
+    {
+        auto prefixName = normalizedPrefix( QDir::fromNativeSeparators( prefix.fPrefix.trimmed() ) );
+        if ( prefixName.length() > 1 )
+            prefixName.chop( 1 );
+        auto lang = prefix.fLang.trimmed();
+
+        auto && curr = prefixes[ { prefixName, lang } ];
+        curr.fPrefix = prefixName;
+        curr.fLang = lang;
+        for ( auto && file : prefix.fFiles )
+        {
+            auto newFile = file;
+            newFile.fFileName = normalizedFileName( QDir::fromNativeSeparators( file.fFileName.trimmed() ) );
+            newFile.fAlias = file.fAlias.trimmed();
+            normalizeCompression( newFile );
+            curr.fFiles.push_back( newFile );
+        }
+    }
+
+    CQRCDocument retVal( fFileName );
+    for ( auto && ii : prefixes )
+    {
+        auto prefix = ii.second;
+        std::stable_sort( prefix.fFiles.begin(), prefix.fFiles.end(),
+                          []( const SQRCFile & lhs, const SQRCFile & rhs )
+                          {
+                              auto lhsName = lhs.resourceName();
+                              auto rhsName = rhs.resourceName();
+                              if ( lhsName != rhsName )
+                                  return lhsName < rhsName;
+                              return lhs.fFileName < rhs.fFileName;
+                          } );
+        retVal.fPrefixes.push_back( prefix );
+    }
+    return retVal;
+}
+
+bool CQRCDocument::save( const QString & fileName, QString * errorMsg, bool canonical ) const
+{
+    if ( canonical )
+        return canonicalized().write( fileName, errorMsg, QFile::WriteOnly | QFile::Truncate );
+    return write( fileName, errorMsg, QFile::WriteOnly | QFile::Truncate | QFile::Text );
+}
+
+bool CQRCDocument::write( const QString & fileName, QString * errorMsg, QIODevice::OpenMode mode ) const
+{
+    auto file = QFile( fileName );
+    if ( !file.open( mode ) )
+    {
+        if ( errorMsg )
+            *errorMsg = QObject::tr( "Could not open Resource File '%1' for writing" ).arg( fileName );
+        return false;
+    }
+
+    QXmlStreamWriter writer( &file );
+    writer.setAutoFormatting( true );
+    writer.writeStartDocument();
+    writer.writeStartElement( "RCC" );
+
+    for ( auto && prefix : fPrefixes )
+    {
+        writer.writeStartElement( "qresource" );
+            if ( !prefix.fLang.isEmpty() )
+                writer.writeAttribute( "lang", prefix.fLang );
+            writer.writeAttribute( "prefix", prefix.fPrefix.isEmpty() ? QString( "/" ) : prefix.fPrefix );
+
+            for ( auto && curr : prefix.fFiles )
+            {
+                writer.writeStartElement( "file" );
+                    if ( !curr.fAlias.isEmpty() )
+                        writer.writeAttribute( "alias", curr.fAlias );
+
+                    if ( !curr.fAlgo.isEmpty() )
+                    {
+                        writer.writeAttribute( "compress-algo", curr.fAlgo );
+                        if ( !curr.fLevel.isEmpty() )
+                            writer.writeAttribute( "compress", curr.fLevel );
+                    }
+                    if ( !curr.fThreshold.isEmpty() )
+                        writer.writeAttribute( "threshold", curr.fThreshold );
+
+                    writer.writeCharacters( normalizedFileName( curr.fFileName ) );
+                writer.writeEndElement();
+            }
+        writer.writeEndElement();
+    }
+
+    writer.writeEndElement();
+    writer.writeEndDocument();
+
+    if ( writer.hasError() )
+    {
+        if ( errorMsg )
+            *errorMsg = QObject::tr( "Error writing Resource File '%1'" ).arg( fileName );
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,95 @@
+// The MIT License( MIT )
+//
+// Copyright( c ) 2020-2021 Scott Aron Bloom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _QRCDOCUMENT_H
+#define _QRCDOCUMENT_H
+
+#include <QString>
+#include <QDir>
+#include <QIODevice>
+#include <vector>
+
+// a single <file> entry, the compression values are stored as they are written to the qrc
+// ie, empty when the rcc default applies
+struct SQRCFile
+{
+    QString fFileName; // relative to the qrc file's directory, no leading "./"
+    QString fAlias;
+    QString fAlgo;
+    QString fLevel;
+    QString fThreshold;
+
+    // the name the file is registered under, relative to its prefix
+    QString resourceName() const;
+};
+
+// a <qresource> block
+struct SQRCPrefix
+{
+    QString fPrefix;
+    QString fLang;
+    std::vector< SQRCFile > fFiles;
+};
+
+class CQRCDocument
+{
+public:
+    CQRCDocument() = default;
+    explicit CQRCDocument( const QString & fileName );
+
+    bool load( const QString & fileName, QString * errorMsg = nullptr );
+    // canonical output is sorted, trimmed and always uses \n line endings
+    // so semantically identical documents are byte identical on disk
+    bool save( const QString & fileName, QString * errorMsg = nullptr, bool canonical = false ) const;
+
+    // prefixes sorted by prefix then language, with duplicates merged, files sorted by resource name then file name
+    // and compression defaults removed
+    CQRCDocument canonicalized() const;
+
+    QString fileName() const { return fFileName; }
+    void setFileName( const QString & fileName ) { fFileName = fileName; }
+    QDir relToDir() const;
+    // a copy saved as fileName, the file names are rewritten relative to its directory so they reference the same files
+    // an alias is pinned where the new file name would change the resource path
+    CQRCDocument rebased( const QString & fileName ) const;
+    // the file's name relative to dir rather than this document's directory
+    QString relativeFileName( const SQRCFile & file, const QDir & dir ) const;
+
+    const std::vector< SQRCPrefix > & prefixes() const { return fPrefixes; }
+    std::vector< SQRCPrefix > & prefixes() { return fPrefixes; }
+
+    QString absoluteFilePath( const SQRCFile & file ) const;
+
+    // ":/prefix/name" as used by QFile/QIcon etc
+    static QString resourcePath( const QString & prefix, const SQRCFile & file );
+    static QString resourcePath( const QString & prefix, const QString & resourceName );
+    static QString normalizedPrefix( const QString & prefix );
+    static QString normalizedFileName( const QString & fileName );
+    // trims the compression values and clears the ones that restate the rcc defaults
+    static void normalizeCompression( SQRCFile & file );
+private:
+    bool write( const QString & fileName, QString * errorMsg, QIODevice::OpenMode mode ) const;
+
+    QString fFileName;
+    std::vector< SQRCPrefix > fPrefixes;
+};
+#endif
@@ -0,0 +1,332 @@
+// The MIT License( MIT )
+//
+// Copyright( c ) 2020-2021 Scott Aron Bloom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "QRCIndexGenerator.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <numeric>
+#include <set>
+#include <unordered_set>
+
+CQRCIndexGenerator::CQRCIndexGenerator( const CQRCDocument & doc ) :
+    fDocument( doc )
+{
+}
+
+QString CQRCIndexGenerator::defaultHeaderFile( const QString & qrcFile )
+{
+    auto fi = QFileInfo( qrcFile );
+    return fi.absoluteDir().absoluteFilePath( QString( "%1_qrcindex.h" ).arg( fi.completeBaseName() ) );
+}
+
+std::uint32_t CQRCIndexGenerator::hash( const QByteArray & str, std::uint32_t seed )
+{
+    std::uint32_t retVal = 0x811C9DC5u ^ seed;
+    for ( auto && ch : str )
+    {
+        retVal ^= static_cast< std::uint8_t >( ch );
+        retVal *= 0x01000193u;
+    }
+    return retVal;
+}
+
+QStringList CQRCIndexGenerator::resourcePaths() const
+{
+    // the same path registered for multiple languages is a single resource to the application
+    QStringList retVal;
+    std::unordered_set< QString > seen;
+    for ( auto && prefix : fDocument.prefixes() )
+    {
+        for ( auto && file : prefix.fFiles )
+        {
+            auto path = CQRCDocument::resourcePath( prefix.fPrefix, file );
+            if ( seen.insert( path ).second )
+                retVal << path;
+        }
+    }
+    return retVal;
+}
+
+// hash and displace, each bucket gets the first seed that places all its keys into free slots
+bool CQRCIndexGenerator::buildPerfectHash( const std::vector< QByteArray > & keys, std::vector< std::uint32_t > & seeds, std::vector< std::uint32_t > & slots )
+{
+    auto numKeys = static_cast< std::uint32_t >( keys.size() );
+    auto numBuckets = std::max( numKeys, 1U );
+
+    std::vector< std::vector< std::uint32_t > > buckets( numBuckets );
+    for ( std::uint32_t ii = 0; ii < numKeys; ++ii )
+        buckets[ hash( keys[ ii ], 0 ) % numBuckets ].push_back( ii );
+
+    std::vector< std::uint32_t > order( numBuckets );
+    std::iota( order.begin(), order.end(), 0 );
+    std::stable_sort( order.begin(), order.end(), [&buckets]( std::uint32_t lhs, std::uint32_t rhs ) { return buckets[ lhs ].size() > buckets[ rhs ].size(); } );
+
+    seeds.assign( numBuckets, 0 );
+    slots.assign( std::max( numKeys, 1U ), numKeys );
+
+    std::vector< std::uint32_t > used;
+    for ( auto && bucketNum : order )
+    {
+        auto && bucket = buckets[ bucketNum ];
+        if ( bucket.empty() )
+            break;
+
+        bool placed = false;
+        for ( std::uint32_t seed = 1; !placed && ( seed < 0x7FFFFFFFU ); ++seed )
+        {
+            used.clear();
+            placed = true;
+            for ( auto && key : bucket )
+            {
+                auto slot = hash( keys[ key ], seed ) % numKeys;
+                if ( ( slots[ slot ] != numKeys ) || ( std::find( used.begin(), used.end(), slot ) != used.end() ) )
+                {
+                    placed = false;
+                    break;
+                }
+                used.push_back( slot );
+            }
+            if ( placed )
+            {
+                seeds[ bucketNum ] = seed;
+                for ( size_t ii = 0; ii < bucket.size(); ++ii )
+                    slots[ used[ ii ] ] = bucket[ ii ];
+            }
+        }
+        if ( !placed )
+            return false;
+    }
+    return true;
+}
+
+QString CQRCIndexGenerator::identifier( const QString & str )
+{
+    QString retVal;
+    for ( auto && ch : str )
+    {
+        if ( ( ch.unicode() < 128 ) && ch.isLetterOrNumber() )
+            retVal += ch;
+        else if ( !retVal.isEmpty() && !retVal.endsWith( '_' ) )
+            retVal += '_';
+    }
+    while ( retVal.endsWith( '_' ) )
+        retVal.chop( 1 );
+    if ( retVal.isEmpty() )
+        return QString();
+    retVal[ 0 ] = retVal[ 0 ].toUpper();
+    return retVal;
+}
+
+QByteArray CQRCIndexGenerator::cppString( const QByteArray & str )
+{
+    QByteArray retVal = "\"";
+    for ( auto && ch : str )
+    {
+        auto uch = static_cast< unsigned char >( ch );
+        if ( ( ch == '"' ) || ( ch == '\\' ) )
+            retVal += '\\' + QByteArray( 1, ch );
+        else if ( ( uch < 0x20 ) || ( uch >= 0x7F ) )
+            retVal += QString( "\\%1" ).arg( static_cast< uint >( uch ), 3, 8, QChar( '0' ) ).toLatin1(); // octal, hex escapes would swallow following hex digits
+        else
+            retVal += ch;
+    }
+    retVal += "\"";
+    return retVal;
+}
+
+QByteArray CQRCIndexGenerator::generate( QString * errorMsg ) const
+{
+    auto paths = resourcePaths();
+
+    std::vector< QByteArray > keys;
+    keys.reserve( paths.size() );
+    for ( auto && ii : paths )
+        keys.push_back( ii.toUtf8() );
+
+    std::vector< std::uint32_t > seeds;
+    std::vector< std::uint32_t > slots;
+    if ( !buildPerfectHash( keys, seeds, slots ) )
+    {
+        if ( errorMsg )
+            *errorMsg = QObject::tr( "Could not build a perfect hash for the resource paths" );
+        return QByteArray();
+    }
+
+    auto baseName = QFileInfo( fDocument.fileName() ).completeBaseName();
+    auto baseId = identifier( baseName );
+    if ( baseId.isEmpty() )
+        baseId = "Resources";
+    auto guard = QString( "_%1_QRCINDEX_H" ).arg( baseId.toUpper() ).toLatin1();
+
+    QByteArray retVal;
+    retVal += "// Generated by qrceditor from " + QFileInfo( fDocument.fileName() ).fileName().toUtf8() + ", do not edit\n";
+    retVal += "\n";
+    retVal += "#ifndef " + guard + "\n";
+    retVal += "#define " + guard + "\n";
+    retVal += "\n";
+    retVal += "#include <cstddef>\n";
+    retVal += "#include <cstdint>\n";
+    retVal += "#include <iterator>\n";
+    retVal += "#include <string_view>\n";
+    retVal += "#ifdef QT_CORE_LIB\n";
+    retVal += "#include <QString>\n";
+    retVal += "#endif\n";
+    retVal += "\n";
+    retVal += "namespace NQRC" + baseId.toLatin1() + "\n";
+    retVal += "{\n";
+
+    retVal += "    enum class EResource : std::size_t\n";
+    retVal += "    {\n";
+    std::set< QString > usedIds = { "eCount" }; // reserved for the sentinel
+    for ( auto && ii : paths )
+    {
+        auto id = "e" + identifier( ii );
+        if ( id == "e" )
+            id = "eRoot";
+        auto uniqueId = id;
+        for ( int cnt = 2; !usedIds.insert( uniqueId ).second; ++cnt )
+            uniqueId = QString( "%1_%2" ).arg( id ).arg( cnt );
+        retVal += "        " + uniqueId.toLatin1() + ", // " + QString( ii ).replace( '\n', ' ' ).toUtf8() + "\n";
+    }
+    retVal += "        eCount\n";
+    retVal += "    };\n";
+    retVal += "\n";
+    retVal += "    inline constexpr std::size_t kCount = static_cast< std::size_t >( EResource::eCount );\n";
+    retVal += "\n";
+    retVal += "    inline constexpr std::string_view kPaths[] =\n";
+    retVal += "    {\n";
+    for ( auto && ii : keys )
+        retVal += "        " + cppString( ii ) + ",\n";
+    if ( keys.empty() )
+        retVal += "        std::string_view()\n";
+    retVal += "    };\n";
+    retVal += "\n";
+    retVal += "    constexpr std::string_view path( EResource resource )\n";
+    retVal += "    {\n";
+    retVal += "        return kPaths[ static_cast< std::size_t >( resource ) ];\n";
+    retVal += "    }\n";
+    retVal += "\n";
+
+    auto writeTable = [&retVal]( const char * name, const std::vector< std::uint32_t > & values )
+    {
+        retVal += QByteArray( "        inline constexpr std::uint32_t " ) + name + "[] =\n";
+        retVal += "        {";
+        for ( size_t ii = 0; ii < values.size(); ++ii )
+        {
+            if ( ( ii % 16 ) == 0 )
+                retVal += "\n            ";
+            retVal += QByteArray::number( values[ ii ] ) + ",";
+            if ( ( ( ii % 16 ) != 15 ) && ( ( ii + 1 ) != values.size() ) )
+                retVal += " ";
+        }
+        retVal += "\n        };\n";
+    };
+
+    retVal += "    namespace NDetail\n";
+    retVal += "    {\n";
+    retVal += "        constexpr std::uint32_t hash( std::string_view str, std::uint32_t seed )\n";
+    retVal += "        {\n";
+    retVal += "            std::uint32_t retVal = 0x811C9DC5u ^ seed;\n";
+    retVal += "            for ( auto && ch : str )\n";
+    retVal += "            {\n";
+    retVal += "                retVal ^= static_cast< std::uint8_t >( ch );\n";
+    retVal += "                retVal *= 0x01000193u;\n";
+    retVal += "            }\n";
+    retVal += "            return retVal;\n";
+    retVal += "        }\n";
+    retVal += "\n";
+    writeTable( "kSeeds", seeds );
+    retVal += "\n";
+    writeTable( "kSlots", slots );
+    retVal += "    }\n";
+    retVal += "\n";
+    retVal += "    // kCount when the path is not a resource\n";
+    if ( keys.empty() )
+    {
+        // no modulo by a constant zero, even dead code trips -Wdiv-by-zero
+        retVal += "    constexpr std::size_t indexOf( std::string_view )\n";
+        retVal += "    {\n";
+        retVal += "        return kCount;\n";
+        retVal += "    }\n";
+    }
+    else
+    {
+        retVal += "    constexpr std::size_t indexOf( std::string_view path )\n";
+        retVal += "    {\n";
+        retVal += "        auto seed = NDetail::kSeeds[ NDetail::hash( path, 0 ) % std::size( NDetail::kSeeds ) ];\n";
+        retVal += "        auto index = NDetail::kSlots[ NDetail::hash( path, seed ) % kCount ];\n";
+        retVal += "        return ( kPaths[ index ] == path ) ? index : kCount;\n";
+        retVal += "    }\n";
+    }
+    retVal += "\n";
+    retVal += "    constexpr bool contains( std::string_view path )\n";
+    retVal += "    {\n";
+    retVal += "        return indexOf( path ) != kCount;\n";
+    retVal += "    }\n";
+    retVal += "\n";
+    retVal += "    // in a constant expression an unknown path fails to compile\n";
+    retVal += "    constexpr EResource resource( std::string_view path )\n";
+    retVal += "    {\n";
+    retVal += "        return contains( path ) ? static_cast< EResource >( indexOf( path ) ) : throw \"Unknown Qt resource path\";\n";
+    retVal += "    }\n";
+    retVal += "\n";
+    retVal += "#ifdef QT_CORE_LIB\n";
+    retVal += "    inline QString toQString( EResource resource )\n";
+    retVal += "    {\n";
+    retVal += "        auto retVal = path( resource );\n";
+    retVal += "        return QString::fromUtf8( retVal.data(), static_cast< int >( retVal.size() ) );\n";
+    retVal += "    }\n";
+    retVal += "#endif\n";
+    retVal += "}\n";
+    retVal += "#endif\n";
+    return retVal;
+}
+
+bool CQRCIndexGenerator::write( const QString & headerFile, bool * changed, QString * errorMsg ) const
+{
+    if ( changed )
+        *changed = false;
+
+    auto contents = generate( errorMsg );
+    if ( contents.isEmpty() )
+        return false;
+
+    QFile existing( headerFile );
+    if ( existing.open( QFile::ReadOnly ) && ( existing.readAll() == contents ) )
+        return true;
+    existing.close();
+
+    QSaveFile file( headerFile );
+    if ( !file.open( QFile::WriteOnly ) || ( file.write( contents ) != contents.size() ) || !file.commit() )
+    {
+        if ( errorMsg )
+            *errorMsg = QObject::tr( "Could not write Resource Index Header '%1'" ).arg( headerFile );
+        return false;
+    }
+    if ( changed )
+        *changed = true;
+    return true;
+}
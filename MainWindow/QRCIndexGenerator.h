@@ -0,0 +1,60 @@
+// The MIT License( MIT )
+//
+// Copyright( c ) 2020-2021 Scott Aron Bloom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _QRCINDEXGENERATOR_H
+#define _QRCINDEXGENERATOR_H
+
+#include "QRCDocument.h"
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <cstdint>
+#include <vector>
+
+// Generates a C++17 header containing a constexpr table of every resource path in the document,
+// a typed handle (enum value) per path and a compile time perfect hash for path lookups
+class CQRCIndexGenerator
+{
+public:
+    CQRCIndexGenerator( const CQRCDocument & doc );
+
+    QByteArray generate( QString * errorMsg = nullptr ) const;
+
+    // only writes the file when the contents changed, so dependent code is not rebuilt needlessly
+    bool write( const QString & headerFile, bool * changed = nullptr, QString * errorMsg = nullptr ) const;
+
+    static QString defaultHeaderFile( const QString & qrcFile );
+
+    // FNV-1a, must match the hash emitted into the header
+    static std::uint32_t hash( const QByteArray & str, std::uint32_t seed );
+
+    // key ii is found at slots[ hash( key, seeds[ hash( key, 0 ) % seeds.size() ] ) % keys.size() ] == ii
+    static bool buildPerfectHash( const std::vector< QByteArray > & keys, std::vector< std::uint32_t > & seeds, std::vector< std::uint32_t > & slots );
+private:
+    QStringList resourcePaths() const;
+    static QString identifier( const QString & str );
+    static QByteArray cppString( const QByteArray & str );
+
+    const CQRCDocument & fDocument;
+};
+#endif
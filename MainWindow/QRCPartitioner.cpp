@@ -0,0 +1,303 @@
+// The MIT License( MIT )
+//
+// Copyright( c ) 2020-2021 Scott Aron Bloom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "QRCPartitioner.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QLibraryInfo>
+#include <QStandardPaths>
+#include <QProcess>
+#include <QLocale>
+
+#include <algorithm>
+#include <map>
+
+CQRCPartitioner::CQRCPartitioner( const CQRCDocument & doc ) :
+    fDocument( doc )
+{
+}
+
+QString normalizedUsagePath( QString path )
+{
+    if ( path.startsWith( "qrc:" ) )
+        path = path.mid( 4 );
+    else if ( path.startsWith( ":" ) )
+        path = path.mid( 1 );
+    return QString( ":%1" ).arg( QDir::cleanPath( "/" + path ) );
+}
+
+bool CQRCPartitioner::setUsageFile( const QString & fileName, QString * errorMsg )
+{
+    fUsedPaths.clear();
+    QFile file( fileName );
+    if ( !file.open( QFile::ReadOnly | QFile::Text ) )
+    {
+        if ( errorMsg )
+            *errorMsg = QObject::tr( "Could not open usage file '%1'" ).arg( fileName );
+        return false;
+    }
+
+    QTextStream ts( &file );
+    while ( !ts.atEnd() )
+    {
+        auto line = ts.readLine().trimmed();
+        if ( line.isEmpty() || line.startsWith( '#' ) )
+            continue;
+        fUsedPaths.insert( normalizedUsagePath( line ) );
+    }
+    return true;
+}
+
+QString CQRCPartitioner::rccExecutable()
+{
+    auto retVal = QStandardPaths::findExecutable( "rcc", { QLibraryInfo::location( QLibraryInfo::BinariesPath ) } );
+    if ( retVal.isEmpty() )
+        retVal = QStandardPaths::findExecutable( "rcc" );
+    return retVal;
+}
+
+std::vector< CQRCPartitioner::TEntries > CQRCPartitioner::packByBudget( const TEntries & entries ) const
+{
+    std::vector< TEntries > retVal;
+    qint64 currBytes = 0;
+    for ( auto && ii : entries )
+    {
+        if ( retVal.empty() || ( ( fShardBudget > 0 ) && !retVal.back().empty() && ( ( currBytes + ii.fBytes ) > fShardBudget ) ) )
+        {
+            retVal.emplace_back();
+            currBytes = 0;
+        }
+        retVal.back().push_back( ii );
+        currBytes += ii.fBytes;
+    }
+    return retVal;
+}
+
+bool CQRCPartitioner::run( SReport & report, QString * errorMsg )
+{
+    report = SReport();
+
+    auto outDir = fOutputDir.isEmpty() ? fDocument.relToDir() : QDir( fOutputDir );
+    if ( !outDir.exists() && !outDir.mkpath( "." ) )
+    {
+        if ( errorMsg )
+            *errorMsg = QObject::tr( "Could not create output directory '%1'" ).arg( outDir.absolutePath() );
+        return false;
+    }
+
+    auto baseName = fBaseName;
+    if ( baseName.isEmpty() )
+        baseName = QFileInfo( fDocument.fileName() ).completeBaseName();
+    if ( baseName.isEmpty() )
+        baseName = "resources";
+
+    TEntries entries;
+    for ( auto && prefix : fDocument.prefixes() )
+    {
+        for ( auto && file : prefix.fFiles )
+        {
+            auto fi = QFileInfo( fDocument.absoluteFilePath( file ) );
+            if ( !fi.exists() )
+                report.fWarnings << QObject::tr( "File '%1' does not exist" ).arg( fi.absoluteFilePath() );
+            entries.push_back( { &prefix, &file, fi.size() } );
+            report.fTotalBytes += fi.size();
+        }
+    }
+
+    TEntries core;
+    std::vector< TEntries > shards;
+    switch ( fStrategy )
+    {
+        case EStrategy::eBySize:
+        {
+            auto bySize = entries;
+            std::stable_sort( bySize.begin(), bySize.end(), []( const SEntry & lhs, const SEntry & rhs ) { return lhs.fBytes < rhs.fBytes; } );
+
+            std::unordered_set< const SQRCFile * > inCore;
+            qint64 coreBytes = 0;
+            for ( auto && ii : bySize )
+            {
+                if ( ( coreBytes + ii.fBytes ) > fCoreBudget )
+                    break;
+                coreBytes += ii.fBytes;
+                inCore.insert( ii.fFile );
+            }
+
+            // keep document order in the outputs
+            TEntries rest;
+            for ( auto && ii : entries )
+                ( inCore.count( ii.fFile ) ? core : rest ).push_back( ii );
+            shards = packByBudget( rest );
+        }
+        break;
+        case EStrategy::eByPrefix:
+        {
+            std::vector< std::pair< qint64, TEntries > > groups;
+            std::map< const SQRCPrefix *, size_t > groupPos;
+            for ( auto && ii : entries )
+            {
+                auto pos = groupPos.find( ii.fPrefix );
+                if ( pos == groupPos.end() )
+                {
+                    pos = groupPos.insert( { ii.fPrefix, groups.size() } ).first;
+                    groups.emplace_back();
+                }
+                groups[ ( *pos ).second ].first += ii.fBytes;
+                groups[ ( *pos ).second ].second.push_back( ii );
+            }
+            std::stable_sort( groups.begin(), groups.end(), []( const auto & lhs, const auto & rhs ) { return lhs.first < rhs.first; } );
+
+            qint64 coreBytes = 0;
+            for ( auto && ii : groups )
+            {
+                if ( ( coreBytes + ii.first ) <= fCoreBudget )
+                {
+                    coreBytes += ii.first;
+                    core.insert( core.end(), ii.second.begin(), ii.second.end() );
+                    continue;
+                }
+                auto packed = packByBudget( ii.second );
+                shards.insert( shards.end(), packed.begin(), packed.end() );
+            }
+        }
+        break;
+        case EStrategy::eByUsage:
+        {
+            std::unordered_set< QString > found;
+            TEntries rest;
+            for ( auto && ii : entries )
+            {
+                auto path = CQRCDocument::resourcePath( ii.fPrefix->fPrefix, *ii.fFile );
+                if ( fUsedPaths.count( path ) )
+                {
+                    found.insert( path );
+                    core.push_back( ii );
+                }
+                else
+                    rest.push_back( ii );
+            }
+            for ( auto && ii : fUsedPaths )
+            {
+                if ( !found.count( ii ) )
+                    report.fWarnings << QObject::tr( "Used resource '%1' is not in the document" ).arg( ii );
+            }
+            shards = packByBudget( rest );
+        }
+        break;
+    }
+
+    if ( !writeShard( core, outDir.absoluteFilePath( QString( "%1_core" ).arg( baseName ) ), false, report.fCore, report, errorMsg ) )
+        return false;
+
+    int shardNum = 1;
+    for ( auto && ii : shards )
+    {
+        if ( ii.empty() )
+            continue;
+        SShard shard;
+        if ( !writeShard( ii, outDir.absoluteFilePath( QString( "%1_shard%2" ).arg( baseName ).arg( shardNum++ ) ), fCompileShards, shard, report, errorMsg ) )
+            return false;
+        report.fShards.push_back( shard );
+    }
+    return true;
+}
+
+bool CQRCPartitioner::writeShard( const TEntries & entries, const QString & name, bool compile, SShard & shard, SReport & report, QString * errorMsg ) const
+{
+    shard.fQRCFile = name + ".qrc";
+
+    CQRCDocument doc( shard.fQRCFile );
+    auto newRelToDir = doc.relToDir();
+
+    std::map< const SQRCPrefix *, size_t > prefixPos;
+    for ( auto && ii : entries )
+    {
+        auto pos = prefixPos.find( ii.fPrefix );
+        if ( pos == prefixPos.end() )
+        {
+            pos = prefixPos.insert( { ii.fPrefix, doc.prefixes().size() } ).first;
+            doc.prefixes().push_back( { ii.fPrefix->fPrefix, ii.fPrefix->fLang, {} } );
+        }
+
+        // the file name is relative to the new qrc, if that changes the registered name, pin it with an alias
+        auto file = *ii.fFile;
+        auto resourceName = file.resourceName();
+        file.fFileName = newRelToDir.relativeFilePath( fDocument.absoluteFilePath( *ii.fFile ) );
+        if ( file.fAlias.isEmpty() && ( CQRCDocument::normalizedFileName( file.fFileName ) != resourceName ) )
+            file.fAlias = resourceName;
+
+        doc.prefixes()[ ( *pos ).second ].fFiles.push_back( file );
+        shard.fBytes += ii.fBytes;
+        shard.fNumFiles++;
+    }
+
+    if ( !doc.save( shard.fQRCFile, errorMsg ) )
+        return false;
+
+    if ( !compile )
+        return true;
+
+    auto rcc = rccExecutable();
+    if ( rcc.isEmpty() )
+    {
+        report.fWarnings << QObject::tr( "Could not find rcc, '%1' was not compiled" ).arg( shard.fQRCFile );
+        return true;
+    }
+
+    auto rccFile = name + ".rcc";
+    QProcess process;
+    process.start( rcc, { "-binary", shard.fQRCFile, "-o", rccFile } );
+    if ( !process.waitForFinished( -1 ) || ( process.exitStatus() != QProcess::NormalExit ) || ( process.exitCode() != 0 ) )
+    {
+        report.fWarnings << QObject::tr( "rcc failed for '%1': %2" ).arg( shard.fQRCFile ).arg( QString::fromLocal8Bit( process.readAllStandardError() ).trimmed() );
+        return true;
+    }
+    shard.fRCCFile = rccFile;
+    return true;
+}
+
+QString CQRCPartitioner::SReport::toString() const
+{
+    QLocale locale;
+    auto percent = [this]( qint64 bytes ) { return fTotalBytes ? ( 100.0 * bytes / fTotalBytes ) : 0.0; };
+
+    QStringList retVal;
+    retVal << QObject::tr( "Total resource size: %1" ).arg( locale.formattedDataSize( fTotalBytes ) );
+    retVal << QObject::tr( "Core (embedded): %1 in %2 file(s) - %3" ).arg( locale.formattedDataSize( fCore.fBytes ) ).arg( fCore.fNumFiles ).arg( fCore.fQRCFile );
+
+    qint64 externalBytes = 0;
+    for ( auto && ii : fShards )
+    {
+        externalBytes += ii.fBytes;
+        retVal << QObject::tr( "Shard: %1 in %2 file(s) - %3" ).arg( locale.formattedDataSize( ii.fBytes ) ).arg( ii.fNumFiles ).arg( ii.fRCCFile.isEmpty() ? ii.fQRCFile : ii.fRCCFile );
+    }
+    retVal << QObject::tr( "Expected startup size reduction: %1 (%2%)" ).arg( locale.formattedDataSize( externalBytes ) ).arg( percent( externalBytes ), 0, 'f', 1 );
+
+    if ( !fWarnings.isEmpty() )
+    {
+        retVal << QString() << QObject::tr( "Warnings:" );
+        retVal << fWarnings;
+    }
+    return retVal.join( "\n" );
+}
@@ -0,0 +1,99 @@
+// The MIT License( MIT )
+//
+// Copyright( c ) 2020-2021 Scott Aron Bloom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _QRCPARTITIONER_H
+#define _QRCPARTITIONER_H
+
+#include "QRCDocument.h"
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <unordered_set>
+#include <vector>
+
+// Splits a document into a core qrc, to be compiled into the application,
+// and external shards that are compiled to .rcc files and registered on demand via QResource::registerResource.
+// Every file keeps its prefix, and is given an explicit alias when needed, so each ":/" path is unchanged
+class CQRCPartitioner
+{
+public:
+    enum class EStrategy
+    {
+        eBySize,   // smallest files go to the core until the core budget is used, the rest is packed by the shard budget
+        eByPrefix, // each prefix/language becomes a unit, the smallest prefixes go to the core
+        eByUsage   // the resource paths listed in the usage file go to the core, the rest is packed by the shard budget
+    };
+
+    struct SShard
+    {
+        QString fQRCFile;
+        QString fRCCFile; // empty when not compiled
+        qint64 fBytes{ 0 };
+        int fNumFiles{ 0 };
+    };
+
+    struct SReport
+    {
+        qint64 fTotalBytes{ 0 };
+        SShard fCore;
+        std::vector< SShard > fShards;
+        QStringList fWarnings;
+
+        QString toString() const;
+    };
+
+    CQRCPartitioner( const CQRCDocument & doc );
+
+    void setStrategy( EStrategy strategy ) { fStrategy = strategy; }
+    void setCoreBudget( qint64 bytes ) { fCoreBudget = bytes; }
+    void setShardBudget( qint64 bytes ) { fShardBudget = bytes; }
+    bool setUsageFile( const QString & fileName, QString * errorMsg = nullptr );
+    void setOutputDir( const QString & dir ) { fOutputDir = dir; }
+    void setBaseName( const QString & baseName ) { fBaseName = baseName; }
+    void setCompileShards( bool compile ) { fCompileShards = compile; }
+
+    bool run( SReport & report, QString * errorMsg = nullptr );
+
+    static QString rccExecutable();
+private:
+    struct SEntry
+    {
+        const SQRCPrefix * fPrefix{ nullptr };
+        const SQRCFile * fFile{ nullptr };
+        qint64 fBytes{ 0 };
+    };
+    using TEntries = std::vector< SEntry >;
+
+    std::vector< TEntries > packByBudget( const TEntries & entries ) const;
+    bool writeShard( const TEntries & entries, const QString & name, bool compile, SShard & shard, SReport & report, QString * errorMsg ) const;
+
+    const CQRCDocument & fDocument;
+    EStrategy fStrategy{ EStrategy::eBySize };
+    qint64 fCoreBudget{ 1024 * 1024 };
+    qint64 fShardBudget{ 4 * 1024 * 1024 };
+    std::unordered_set< QString > fUsedPaths;
+    QString fOutputDir;
+    QString fBaseName;
+    bool fCompileShards{ true };
+};
+#endif
@@ -21,18 +21,40 @@
 # SOFTWARE.
 
 set(qtproject_SRCS
+    DiffDlg.cpp
+    Headless.cpp
+    ImageOptimizer.cpp
+    LintEngine.cpp
     MainWindow.cpp
+    PartitionDlg.cpp
+    PreviewLoader.cpp
+    QRCDiff.cpp
+    QRCDocument.cpp
+    QRCIndexGenerator.cpp
+    QRCPartitioner.cpp
 )
 
 set(qtproject_H
+    DiffDlg.h
+    LintEngine.h
     MainWindow.h
+    PartitionDlg.h
+    PreviewLoader.h
 )
 
 set(project_H
+    Headless.h
+    ImageOptimizer.h
+    QRCDiff.h
+    QRCDocument.h
+    QRCIndexGenerator.h
+    QRCPartitioner.h
 )
 
 set(qtproject_UIS
+    DiffDlg.ui
     MainWindow.ui
+    PartitionDlg.ui
 )
 
 set(qtproject_QRC
@@ -41,7 +63,8 @@ set(qtproject_QRC
 
 set( project_pub_DEPS
     ${project_pub_DEPS}
-    Qt5::XmlPatterns
+    Qt5::Concurrent
+    Qt5::Svg
     )
 
 file(GLOB qtproject_QRC_SOURCES "resources/*")
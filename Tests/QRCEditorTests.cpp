@@ -0,0 +1,377 @@
+// The MIT License( MIT )
+//
+// Copyright( c ) 2020-2021 Scott Aron Bloom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "QRCEditorTests.h"
+#include "MainWindow/QRCDiff.h"
+#include "MainWindow/QRCDocument.h"
+#include "MainWindow/QRCIndexGenerator.h"
+
+#include <QtTest>
+#include <QFile>
+#include <QProcess>
+#include <QTemporaryDir>
+
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+    CQRCDocument makeDocument( const QString & fileName, const std::vector< SQRCPrefix > & prefixes )
+    {
+        CQRCDocument retVal( fileName );
+        retVal.prefixes() = prefixes;
+        return retVal;
+    }
+
+    // prefix|lang|file|alias|compress-algo|compress|threshold per entry
+    QStringList describe( const CQRCDocument & doc )
+    {
+        QStringList retVal;
+        for ( auto && prefix : doc.prefixes() )
+        {
+            for ( auto && file : prefix.fFiles )
+                retVal << QStringList( { prefix.fPrefix, prefix.fLang, file.fFileName, file.fAlias, file.fAlgo, file.fLevel, file.fThreshold } ).join( '|' );
+        }
+        return retVal;
+    }
+
+    QStringList resourcePaths( const CQRCDocument & doc )
+    {
+        QStringList retVal;
+        for ( auto && prefix : doc.prefixes() )
+        {
+            for ( auto && file : prefix.fFiles )
+                retVal << CQRCDocument::resourcePath( prefix.fPrefix, file );
+        }
+        return retVal;
+    }
+
+    QByteArray saved( const CQRCDocument & doc, bool canonical )
+    {
+        QTemporaryDir dir;
+        auto fileName = dir.filePath( "saved.qrc" );
+        if ( !doc.save( fileName, nullptr, canonical ) )
+            return QByteArray();
+
+        QFile file( fileName );
+        if ( !file.open( QFile::ReadOnly ) )
+            return QByteArray();
+        return file.readAll();
+    }
+}
+
+void CQRCEditorTests::perfectHash_data()
+{
+    QTest::addColumn< int >( "count" );
+
+    QTest::newRow( "one" ) << 1;
+    QTest::newRow( "two" ) << 2;
+    QTest::newRow( "three" ) << 3;
+    QTest::newRow( "seventeen" ) << 17;
+    QTest::newRow( "thousand" ) << 1000;
+}
+
+void CQRCEditorTests::perfectHash()
+{
+    QFETCH( int, count );
+
+    std::vector< QByteArray > keys;
+    for ( int ii = 0; ii < count; ++ii )
+        keys.push_back( QString( ":/images/icon_%1.png" ).arg( ii ).toUtf8() );
+
+    std::vector< std::uint32_t > seeds;
+    std::vector< std::uint32_t > slots;
+    QVERIFY( CQRCIndexGenerator::buildPerfectHash( keys, seeds, slots ) );
+    QCOMPARE( slots.size(), keys.size() );
+
+    // the same lookup the generated indexOf performs
+    for ( size_t ii = 0; ii < keys.size(); ++ii )
+    {
+        auto seed = seeds[ CQRCIndexGenerator::hash( keys[ ii ], 0 ) % seeds.size() ];
+        auto slot = CQRCIndexGenerator::hash( keys[ ii ], seed ) % keys.size();
+        QCOMPARE( slots[ slot ], static_cast< std::uint32_t >( ii ) );
+    }
+}
+
+void CQRCEditorTests::indexHeaderCompiles_data()
+{
+    QTest::addColumn< QString >( "prefixName" );
+    QTest::addColumn< QStringList >( "files" );
+    QTest::addColumn< bool >( "translated" );
+    QTest::addColumn< QStringList >( "paths" ); // as registered by rcc
+
+    QStringList many;
+    QStringList manyPaths;
+    for ( int ii = 0; ii < 200; ++ii )
+    {
+        many << QString( "images/icon_%1.png" ).arg( ii );
+        manyPaths << QString( ":/images/icon_%1.png" ).arg( ii );
+    }
+
+    QTest::newRow( "empty" ) << QString( "/" ) << QStringList() << false << QStringList();
+    QTest::newRow( "single" ) << QString( "/" ) << QStringList( { "a.png" } ) << false << QStringList( { ":/a.png" } );
+    QTest::newRow( "sentinel names" ) << QString( "/" ) << QStringList( { "count", "Count", "a.png" } ) << false << QStringList( { ":/count", ":/Count", ":/a.png" } );
+    QTest::newRow( "same identifier" ) << QString( "/" ) << QStringList( { "a-b.png", "a_b.png", "a b.png" } ) << false << QStringList( { ":/a-b.png", ":/a_b.png", ":/a b.png" } );
+    QTest::newRow( "translated" ) << QString( "/" ) << QStringList( { "a.png", "b.png" } ) << true << QStringList( { ":/a.png", ":/b.png" } );
+    QTest::newRow( "many" ) << QString( "/" ) << many << false << manyPaths;
+    // rcc strips leading ../ from the name, it never climbs out of the prefix
+    QTest::newRow( "parent directories" ) << QString( "/icons" ) << QStringList( { "../shared/x.png", "../../up.png", "./local.png", "sub/../y.png" } ) << false
+                                          << QStringList( { ":/icons/shared/x.png", ":/icons/up.png", ":/icons/local.png", ":/icons/y.png" } );
+}
+
+void CQRCEditorTests::indexHeaderCompiles()
+{
+#ifndef QRCEDITOR_CXX_COMPILER
+    QSKIP( "Generated headers are only compiled with GCC or Clang" );
+#else
+    QFETCH( QString, prefixName );
+    QFETCH( QStringList, files );
+    QFETCH( bool, translated );
+    QFETCH( QStringList, paths );
+
+    QTemporaryDir dir;
+    QVERIFY( dir.isValid() );
+
+    SQRCPrefix prefix{ prefixName, QString(), {} };
+    for ( auto && ii : files )
+        prefix.fFiles.push_back( { ii } );
+    std::vector< SQRCPrefix > prefixes = { prefix };
+    if ( translated )
+    {
+        // the same paths again, a resource path is a single handle whatever its languages
+        prefix.fLang = "de";
+        prefixes.push_back( prefix );
+    }
+
+    auto doc = makeDocument( dir.filePath( "Test.qrc" ), prefixes );
+    QString msg;
+    QVERIFY2( CQRCIndexGenerator( doc ).write( dir.filePath( "Test_qrcindex.h" ), nullptr, &msg ), qPrintable( msg ) );
+
+    // the header's own hash and tables must find every path at compile time
+    QByteArray source = "#include \"Test_qrcindex.h\"\n\n";
+    source += "static_assert( NQRCTest::kCount == " + QByteArray::number( paths.size() ) + " );\n";
+    for ( int ii = 0; ii < paths.size(); ++ii )
+    {
+        auto path = paths[ ii ].toUtf8();
+        source += "static_assert( NQRCTest::indexOf( \"" + path + "\" ) == " + QByteArray::number( ii ) + " );\n";
+        source += "static_assert( NQRCTest::path( NQRCTest::resource( \"" + path + "\" ) ) == \"" + path + "\" );\n";
+    }
+    source += "static_assert( !NQRCTest::contains( \":/not/a/resource\" ) );\n";
+    source += "\nint main()\n{\n    return 0;\n}\n";
+
+    QFile sourceFile( dir.filePath( "check.cpp" ) );
+    QVERIFY( sourceFile.open( QFile::WriteOnly ) );
+    sourceFile.write( source );
+    sourceFile.close();
+
+    QProcess compiler;
+    compiler.setWorkingDirectory( dir.path() );
+    compiler.start( QRCEDITOR_CXX_COMPILER, { "-std=c++17", "-Wall", "-Wextra", "-Werror", "-fsyntax-only", "check.cpp" } );
+    QVERIFY( compiler.waitForFinished( 120000 ) );
+    QVERIFY2( ( compiler.exitStatus() == QProcess::NormalExit ) && ( compiler.exitCode() == 0 ), compiler.readAllStandardError().constData() );
+#endif
+}
+
+void CQRCEditorTests::canonicalIsIdempotent()
+{
+    auto doc = makeDocument( "Test.qrc",
+                             {
+                                 { " icons ", QString(), { { " ./b.png " }, { "a.png", QString(), "BEST", "9", "70" } } },
+                                 { "/", "de", { { "z.txt", QString(), "zlib", "6", QString() }, { "y.txt", QString(), "none", "3", "50" } } },
+                                 { "icons/", QString(), { { "c.png", QString(), "zstd", "14", " 80 " } } }
+                             } );
+
+    auto once = doc.canonicalized();
+    QCOMPARE( describe( once ), QStringList( {
+                                    "/|de|y.txt||none||",
+                                    "/|de|z.txt||zlib||",
+                                    "/icons||a.png||||",
+                                    "/icons||b.png||||",
+                                    "/icons||c.png||zstd||80"
+                                } ) );
+
+    auto twice = once.canonicalized();
+    QCOMPARE( describe( twice ), describe( once ) );
+
+    auto bytes = saved( doc, true );
+    QVERIFY( !bytes.isEmpty() );
+    QVERIFY( !bytes.contains( '\r' ) );
+    QCOMPARE( saved( once, true ), bytes );
+    QCOMPARE( saved( twice, true ), bytes );
+}
+
+void CQRCEditorTests::canonicalStripsDefaults()
+{
+    auto explicitDefaults = makeDocument( "Test.qrc",
+                                          { { "/", QString(),
+                                              {
+                                                  { "a.png", QString(), QString(), QString(), "70" },
+                                                  { "b.png", QString(), "best", "9", QString() },
+                                                  { "c.png", QString(), "zstd", "14", QString() },
+                                                  { "d.png", QString(), "zlib", "6", QString() },
+                                                  { "e.png", QString(), "none", "5", "30" }
+                                              } } } );
+    auto implicitDefaults = makeDocument( "Test.qrc",
+                                          { { "/", QString(),
+                                              {
+                                                  { "a.png" },
+                                                  { "b.png" },
+                                                  { "c.png", QString(), "zstd" },
+                                                  { "d.png", QString(), "zlib" },
+                                                  { "e.png", QString(), "none" }
+                                              } } } );
+
+    QCOMPARE( describe( explicitDefaults.canonicalized() ), describe( implicitDefaults.canonicalized() ) );
+    QCOMPARE( saved( explicitDefaults, true ), saved( implicitDefaults, true ) );
+}
+
+void CQRCEditorTests::mergeNonOverlapping()
+{
+    auto base = makeDocument( "base.qrc", { { "/", QString(), { { "a.png", QString(), "zlib" }, { "old/x.png", "x.png" } } } } );
+    auto ours = makeDocument( "ours.qrc", { { "/", QString(), { { "a.png", QString(), "zlib", "9" }, { "old/x.png", "x.png" } } } } );
+    auto theirs = makeDocument( "theirs.qrc", { { "/", QString(), { { "a.png", QString(), "zlib", QString(), "50" }, { "new/x.png", "x.png" } } } } );
+
+    CQRCDocument result;
+    std::vector< CQRCDiff::SConflict > conflicts;
+    QVERIFY( CQRCDiff::merge( base, ours, theirs, result, conflicts ) );
+    QVERIFY( conflicts.empty() );
+    QCOMPARE( describe( result ), QStringList( { "/||a.png||zlib|9|50", "/||new/x.png|x.png|||" } ) );
+}
+
+void CQRCEditorTests::mergeConflictKeepsOurs()
+{
+    auto base = makeDocument( "base.qrc", { { "/", QString(), { { "a.png", QString(), "zlib" } } } } );
+    auto ours = makeDocument( "ours.qrc", { { "/", QString(), { { "a.png", QString(), "zlib", "9" } } } } );
+    auto theirs = makeDocument( "theirs.qrc", { { "/", QString(), { { "a.png", QString(), "zlib", "3", "50" } } } } );
+
+    CQRCDocument result;
+    std::vector< CQRCDiff::SConflict > conflicts;
+    QVERIFY( !CQRCDiff::merge( base, ours, theirs, result, conflicts ) );
+    QCOMPARE( conflicts.size(), size_t( 1 ) );
+    QCOMPARE( conflicts.front().fEntry.resourcePath(), QString( ":/a.png" ) );
+    // the level conflicts and keeps ours, the threshold only changed in theirs
+    QCOMPARE( describe( result ), QStringList( { "/||a.png||zlib|9|50" } ) );
+}
+
+void CQRCEditorTests::mergeAddsAndRemoves()
+{
+    auto base = makeDocument( "base.qrc", { { "/", QString(), { { "a.png" }, { "b.png" }, { "c.png" }, { "d.png" } } } } );
+    auto ours = makeDocument( "ours.qrc", { { "/", QString(), { { "a.png" }, { "b.png" }, { "c.png", QString(), QString(), QString(), "50" }, { "e.png" }, { "g.png" } } } } );
+    auto theirs = makeDocument( "theirs.qrc", { { "/", QString(), { { "a.png" }, { "d.png", QString(), QString(), QString(), "40" }, { "f.png" }, { "g.png" } } } } );
+
+    CQRCDocument result;
+    std::vector< CQRCDiff::SConflict > conflicts;
+    QVERIFY( !CQRCDiff::merge( base, ours, theirs, result, conflicts ) );
+
+    // b removed by theirs, c modified by us and removed by theirs (kept), d removed by us and modified by theirs (stays removed)
+    // e and f added on one side, g added identically on both
+    QCOMPARE( conflicts.size(), size_t( 2 ) );
+    QCOMPARE( conflicts[ 0 ].fEntry.resourcePath(), QString( ":/c.png" ) );
+    QCOMPARE( conflicts[ 1 ].fEntry.resourcePath(), QString( ":/d.png" ) );
+    QCOMPARE( describe( result ), QStringList( { "/||a.png||||", "/||c.png||||50", "/||e.png||||", "/||g.png||||", "/||f.png||||" } ) );
+}
+
+void CQRCEditorTests::mergeRebasesTheirs()
+{
+    QTemporaryDir dir;
+    QVERIFY( dir.isValid() );
+
+    // base and theirs are copies in another directory, a.png and b.png are the same files as ours, c.png is theirs' own
+    auto base = makeDocument( dir.filePath( "other/base.qrc" ), { { "/", QString(), { { "../app/images/a.png", "images/a.png" } } } } );
+    auto ours = makeDocument( dir.filePath( "app/ours.qrc" ), { { "/", QString(), { { "images/a.png" } } } } );
+    auto theirs = makeDocument( dir.filePath( "other/theirs.qrc" ), { { "/", QString(), { { "../app/images/a.png", "images/a.png" }, { "../app/images/b.png", "b.png" }, { "c.png" } } } } );
+
+    CQRCDocument result;
+    std::vector< CQRCDiff::SConflict > conflicts;
+    QVERIFY( CQRCDiff::merge( base, ours, theirs, result, conflicts ) );
+    QCOMPARE( result.fileName(), ours.fileName() );
+    QCOMPARE( describe( result ), QStringList( { "/||images/a.png||||", "/||images/b.png|b.png|||", "/||../other/c.png|c.png|||" } ) );
+    QCOMPARE( resourcePaths( result ), QStringList( { ":/images/a.png", ":/b.png", ":/c.png" } ) );
+
+    // saving elsewhere references the same files under the same resource paths
+    auto moved = result.rebased( dir.filePath( "out/merged.qrc" ) );
+    QCOMPARE( describe( moved ), QStringList( { "/||../app/images/a.png|images/a.png|||", "/||../app/images/b.png|b.png|||", "/||../other/c.png|c.png|||" } ) );
+    QCOMPARE( resourcePaths( moved ), resourcePaths( result ) );
+    QCOMPARE( QDir::cleanPath( moved.absoluteFilePath( moved.prefixes().front().fFiles.back() ) ), QDir::cleanPath( result.absoluteFilePath( result.prefixes().front().fFiles.back() ) ) );
+    QVERIFY( CQRCDiff::diff( moved, result ).empty() );
+}
+
+void CQRCEditorTests::diffRebasesFrom()
+{
+    QTemporaryDir dir;
+    QVERIFY( dir.isValid() );
+
+    auto from = makeDocument( dir.filePath( "other/from.qrc" ), { { "/", QString(), { { "../app/images/a.png", "images/a.png" }, { "../app/images/b.png", "b.png" }, { "images/c.png" } } } } );
+    auto to = makeDocument( dir.filePath( "app/to.qrc" ), { { "/", QString(), { { "images/a.png" }, { "images/b.png", "b.png", "none" }, { "images/c.png" } } } } );
+
+    // c.png has the same resource path but is a different file on disk
+    auto changes = CQRCDiff::diff( from, to );
+    QCOMPARE( changes.size(), size_t( 2 ) );
+    QVERIFY( changes[ 0 ].fType == CQRCDiff::EChange::eChanged );
+    QCOMPARE( changes[ 0 ].fNew.resourcePath(), QString( ":/b.png" ) );
+    QCOMPARE( changes[ 0 ].fAttributes, QStringList( { "compress-algo: '' -> 'none'" } ) );
+    QVERIFY( changes[ 1 ].fType == CQRCDiff::EChange::eChanged );
+    QCOMPARE( changes[ 1 ].fNew.resourcePath(), QString( ":/images/c.png" ) );
+    QCOMPARE( changes[ 1 ].fAttributes, QStringList( { "file: '../other/images/c.png' -> 'images/c.png'" } ) );
+}
+
+void CQRCEditorTests::diffNormalizesCompression()
+{
+    QTemporaryDir dir;
+    QVERIFY( dir.isValid() );
+
+    auto fileName = dir.filePath( "Test.qrc" );
+    QFile file( fileName );
+    QVERIFY( file.open( QFile::WriteOnly ) );
+    file.write( "<RCC>\n"
+                "    <qresource prefix=\"/\">\n"
+                "        <file compress-algo=\"zstd\" compress=\"14\">a.png</file>\n"
+                "        <file threshold=\"70\">b.png</file>\n"
+                "        <file compress-algo=\"Best\">c.png</file>\n"
+                "        <file compress-algo=\"ZLIB\" compress=\"9\">d.png</file>\n"
+                "    </qresource>\n"
+                "</RCC>\n" );
+    file.close();
+
+    CQRCDocument disk;
+    QString msg;
+    QVERIFY2( disk.load( fileName, &msg ), qPrintable( msg ) );
+
+    // the same file open in the GUI, CMainWindow::getDocument strips the defaults
+    auto gui = disk;
+    for ( auto && prefix : gui.prefixes() )
+    {
+        for ( auto && ii : prefix.fFiles )
+            CQRCDocument::normalizeCompression( ii );
+    }
+
+    QVERIFY( CQRCDiff::diff( disk, gui ).empty() );
+    QVERIFY( CQRCDiff::diff( gui, disk ).empty() );
+
+    CQRCDocument result;
+    std::vector< CQRCDiff::SConflict > conflicts;
+    QVERIFY( CQRCDiff::merge( disk, gui, disk, result, conflicts ) );
+    QVERIFY( CQRCDiff::merge( gui, disk, gui, result, conflicts ) );
+    QVERIFY( conflicts.empty() );
+}
+
+QTEST_GUILESS_MAIN( CQRCEditorTests )